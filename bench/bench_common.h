@@ -0,0 +1,60 @@
+/**
+ ******************************************************************************
+ * @file    bench_common.h
+ * @brief   Timing and deterministic data helpers shared by the benchmarks
+ ******************************************************************************
+ */
+
+#ifndef BENCH_COMMON_H_
+#define BENCH_COMMON_H_
+
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Monotonic wall-clock time in seconds
+ */
+static inline double bench_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Deterministic pseudo-random generator (64-bit LCG)
+ * @param state Generator state, updated in place
+ * @return Uniform value in [0, 1)
+ */
+static inline float bench_uniform(uint64_t* state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (float)(*state >> 40) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Fill x with evenly spaced values in [lo, hi] and y with a cubic
+ * plus deterministic noise
+ */
+static inline void bench_fill_data(float* x, float* y, int32_t n, float lo,
+                                   float hi, uint64_t seed) {
+  uint64_t state = seed;
+  float step = (n > 1) ? (hi - lo) / (float)(n - 1) : 0.0f;
+  for (int32_t i = 0; i < n; i++) {
+    float xi = lo + step * (float)i;
+    x[i] = xi;
+    y[i] = 0.5f * xi * xi * xi - xi + 2.0f +
+           0.01f * (bench_uniform(&state) - 0.5f);
+  }
+}
+
+/** @brief Volatile sink read back by bench_consume() */
+static volatile float bench_sink;
+
+/**
+ * @brief Keep a value observable so the optimiser cannot drop the work
+ */
+static inline void bench_consume(float value) {
+  // Read-modify-write: the volatile load and store must both happen
+  bench_sink = bench_sink + value;
+}
+
+#endif /* BENCH_COMMON_H_ */
@@ -0,0 +1,66 @@
+/**
+ ******************************************************************************
+ * @file    bench_evaluate_batch.c
+ * @brief   Points-per-second of polyfit_evaluate_batch vs a polyfit_evaluate
+ *          loop
+ ******************************************************************************
+ * Usage: bench_evaluate_batch [num_points] [repeats]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "polyfit.h"
+
+int main(int argc, char** argv) {
+  int32_t n = (argc > 1) ? atoi(argv[1]) : 10000000;
+  int32_t repeats = (argc > 2) ? atoi(argv[2]) : 5;
+
+  float* x = (float*)malloc((size_t)n * sizeof(float));
+  float* y = (float*)malloc((size_t)n * sizeof(float));
+  float* out = (float*)malloc((size_t)n * sizeof(float));
+  if (x == NULL || y == NULL || out == NULL) {
+    fprintf(stderr, "allocation failed\n");
+    return 1;
+  }
+  bench_fill_data(x, y, n, -1.0f, 1.0f, 42);
+
+  printf("%-8s %16s %16s %8s\n", "degree", "scalar pts/s", "batch pts/s",
+         "speedup");
+
+  for (int32_t degree = 1; degree <= POLYFIT_MAX_DEGREE; degree++) {
+    Polynomial* poly = polyfit_init(degree);
+    for (int32_t i = 0; i <= degree; i++) {
+      poly->coefficients[i] = 1.0f / (float)(i + 1);
+    }
+
+    double t0 = bench_now();
+    for (int32_t r = 0; r < repeats; r++) {
+      for (int32_t i = 0; i < n; i++) {
+        polyfit_evaluate(poly, x[i], &out[i]);
+      }
+      bench_consume(out[n / 2]);
+    }
+    double scalar = bench_now() - t0;
+
+    t0 = bench_now();
+    for (int32_t r = 0; r < repeats; r++) {
+      polyfit_evaluate_batch(poly, x, out, n);
+      bench_consume(out[n / 2]);
+    }
+    double batch = bench_now() - t0;
+
+    double points = (double)n * (double)repeats;
+    printf("%-8d %16.3e %16.3e %7.2fx\n", degree, points / scalar,
+           points / batch, scalar / batch);
+    polyfit_free(poly);
+  }
+
+  free(x);
+  free(y);
+  free(out);
+  return 0;
+}
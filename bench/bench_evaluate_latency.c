@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ * @file    bench_evaluate_latency.c
+ * @brief   Single-point latency and accuracy of Horner vs Estrin evaluation
+ ******************************************************************************
+ * Usage: bench_evaluate_latency [samples]
+ *
+ * Each sample times a chain of calls in which every x depends on the
+ * previous result, so the figure is latency rather than throughput. Reports
+ * p50/p99 ns per call for polyfit_evaluate_horner(), polyfit_evaluate_estrin()
+ * and polyfit_evaluate() (which picks by degree), then the largest error of
+ * each scheme against a double-precision reference.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "polyfit.h"
+
+#define CHAIN_LENGTH (256)
+#define NUM_INPUTS (256)
+#define ACCURACY_POINTS (100000)
+
+typedef polyfit_error_t (*evaluate_fn)(const Polynomial*, float, float*);
+
+static int compare_double(const void* a, const void* b) {
+  const double da = *(const double*)a;
+  const double db = *(const double*)b;
+  return (da > db) - (da < db);
+}
+
+/**
+ * @brief Time samples chains of dependent calls; writes p50 and p99 in ns
+ */
+static void measure_latency(evaluate_fn fn, const Polynomial* poly,
+                            const float* inputs, double* samples,
+                            int32_t num_samples, double* p50, double* p99) {
+  float value = 0.0f;
+  for (int32_t s = 0; s < num_samples; s++) {
+    const double t0 = bench_now();
+    for (int32_t i = 0; i < CHAIN_LENGTH; i++) {
+      // 0 * value is not folded without fast-math, so x waits on the result
+      const float x = inputs[i & (NUM_INPUTS - 1)] + 0.0f * value;
+      fn(poly, x, &value);
+    }
+    samples[s] = (bench_now() - t0) * 1e9 / CHAIN_LENGTH;
+  }
+  bench_consume(value);
+
+  qsort(samples, (size_t)num_samples, sizeof(double), compare_double);
+  *p50 = samples[num_samples / 2];
+  *p99 = samples[(int32_t)((double)num_samples * 0.99)];
+}
+
+/**
+ * @brief Largest |fn(x) - p(x)| over [-1, 1], p evaluated in double
+ */
+static double max_error(evaluate_fn fn, const Polynomial* poly) {
+  double worst = 0.0;
+  for (int32_t i = 0; i < ACCURACY_POINTS; i++) {
+    const float x = -1.0f + 2.0f * (float)i / (float)(ACCURACY_POINTS - 1);
+    double reference = 0.0;
+    for (int32_t k = poly->degree; k >= 0; k--) {
+      reference = reference * (double)x + (double)poly->coefficients[k];
+    }
+    float value;
+    fn(poly, x, &value);
+    const double error = fabs((double)value - reference);
+    worst = (error > worst) ? error : worst;
+  }
+  return worst;
+}
+
+int main(int argc, char** argv) {
+  int32_t num_samples = (argc > 1) ? atoi(argv[1]) : 20000;
+  if (num_samples < 100) {
+    num_samples = 100;
+  }
+
+  double* samples = (double*)malloc((size_t)num_samples * sizeof(double));
+  float inputs[NUM_INPUTS];
+  if (samples == NULL) {
+    fprintf(stderr, "allocation failed\n");
+    return 1;
+  }
+  uint64_t state = 7;
+  for (int32_t i = 0; i < NUM_INPUTS; i++) {
+    inputs[i] = 2.0f * bench_uniform(&state) - 1.0f;
+  }
+
+  printf("Estrin from degree %d\n", POLYFIT_ESTRIN_MIN_DEGREE);
+  printf("%-6s | %9s %9s | %9s %9s | %9s %9s | %10s %10s\n", "degree",
+         "horner50", "horner99", "estrin50", "estrin99", "auto50", "auto99",
+         "horner err", "estrin err");
+
+  for (int32_t degree = 1; degree <= POLYFIT_MAX_DEGREE; degree++) {
+    // Alternating, slowly decaying coefficients, as normalized fits produce
+    Polynomial* poly = polyfit_init(degree);
+    for (int32_t k = 0; k <= degree; k++) {
+      poly->coefficients[k] = ((k & 1) ? -1.0f : 1.0f) / (float)(k + 1);
+    }
+
+    double h50, h99, e50, e99, a50, a99;
+    measure_latency(polyfit_evaluate_horner, poly, inputs, samples,
+                    num_samples, &h50, &h99);
+    measure_latency(polyfit_evaluate_estrin, poly, inputs, samples,
+                    num_samples, &e50, &e99);
+    measure_latency(polyfit_evaluate, poly, inputs, samples, num_samples,
+                    &a50, &a99);
+
+    printf("%-6d | %9.2f %9.2f | %9.2f %9.2f | %9.2f %9.2f | %10.2e %10.2e\n",
+           degree, h50, h99, e50, e99, a50, a99,
+           max_error(polyfit_evaluate_horner, poly),
+           max_error(polyfit_evaluate_estrin, poly));
+    polyfit_free(poly);
+  }
+
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @file    bench_fit_template.cpp
+ * @brief   polyfit_cxx::Fit<Degree> vs the runtime-degree C path
+ ******************************************************************************
+ * Usage: bench_fit_template [num_points] [repeats]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "bench_common.h"
+#include "polyfit.hpp"
+
+template <int Degree>
+static void run(const std::vector<float>& x, const std::vector<float>& y,
+                std::vector<float>& out, int32_t repeats) {
+  const int32_t n = static_cast<int32_t>(x.size());
+  const double points = static_cast<double>(n) * repeats;
+
+  // Fit
+  Polynomial* poly = polyfit_init(Degree);
+  double t0 = bench_now();
+  for (int32_t r = 0; r < repeats; r++) {
+    polyfit_least_squares(x.data(), y.data(), n, Degree, poly);
+    bench_consume(poly->coefficients[0]);
+  }
+  double c_fit = bench_now() - t0;
+
+  polyfit_cxx::Fit<Degree> fit;
+  t0 = bench_now();
+  for (int32_t r = 0; r < repeats; r++) {
+    fit.fit(x.data(), y.data(), n);
+    bench_consume(fit.coefficients()[0]);
+  }
+  double t_fit = bench_now() - t0;
+
+  // Scalar evaluation, one call per point
+  t0 = bench_now();
+  for (int32_t r = 0; r < repeats; r++) {
+    for (int32_t i = 0; i < n; i++) {
+      polyfit_evaluate(poly, x[i], &out[i]);
+    }
+    bench_consume(out[n / 2]);
+  }
+  double c_eval = bench_now() - t0;
+
+  t0 = bench_now();
+  for (int32_t r = 0; r < repeats; r++) {
+    fit.evaluate(x.data(), out.data(), n);
+    bench_consume(out[n / 2]);
+  }
+  double t_eval = bench_now() - t0;
+
+  std::printf("%-8d %14.3e %14.3e %7.2fx %14.3e %14.3e %7.2fx\n", Degree,
+              points / c_fit, points / t_fit, c_fit / t_fit, points / c_eval,
+              points / t_eval, c_eval / t_eval);
+  polyfit_free(poly);
+}
+
+int main(int argc, char** argv) {
+  int32_t n = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+  int32_t repeats = (argc > 2) ? std::atoi(argv[2]) : 10;
+
+  std::vector<float> x(n), y(n), out(n);
+  bench_fill_data(x.data(), y.data(), n, -1.0f, 1.0f, 42);
+
+  std::printf("%-8s %14s %14s %8s %14s %14s %8s\n", "degree", "C fit pts/s",
+              "Fit<D> pts/s", "speedup", "C eval pts/s", "Fit<D> pts/s",
+              "speedup");
+  run<2>(x, y, out, repeats);
+  run<3>(x, y, out, repeats);
+  run<5>(x, y, out, repeats);
+  return 0;
+}
@@ -0,0 +1,221 @@
+/**
+ ******************************************************************************
+ * @file    bench_polyfit.c
+ * @brief   Throughput suite for the core fitting and evaluation functions
+ ******************************************************************************
+ * Usage: bench_polyfit [--json] [--max-n N] [--min-time SECONDS]
+ *                      [--filter SUBSTRING]
+ *
+ * Sweeps n over powers of ten from 10 to --max-n (default 10^6; pass 10^8
+ * for the full sweep) and the degree over 0..POLYFIT_MAX_DEGREE for
+ * polyfit_least_squares, polyfit_evaluate, polyfit_r_squared and
+ * polyfit_best_degree. Each case repeats until --min-time has elapsed and
+ * reports ns/point, calls/s (fits/s for the fitting functions) and heap
+ * allocations per call, counted through
+ * polyfit_set_allocator(). Data is generated deterministically in process.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "polyfit.h"
+
+/** @brief Allocation counter installed as the library allocator */
+typedef struct {
+  int64_t allocs;
+} alloc_counter_t;
+
+static void* counting_alloc(size_t size, void* user_data) {
+  ((alloc_counter_t*)user_data)->allocs++;
+  return malloc(size);
+}
+
+static void counting_free(void* ptr, void* user_data) {
+  (void)user_data;
+  free(ptr);
+}
+
+/** @brief Shared state for one benchmark case */
+typedef struct {
+  const float* x;
+  const float* y;
+  float* out;
+  int32_t n;
+  int32_t degree;
+  Polynomial* poly; /**< Preallocated fit of the case's degree */
+} bench_case_t;
+
+typedef void (*bench_fn_t)(bench_case_t* c);
+
+static void run_least_squares(bench_case_t* c) {
+  polyfit_least_squares(c->x, c->y, c->n, c->degree, c->poly);
+  bench_consume(c->poly->coefficients[0]);
+}
+
+static void run_evaluate(bench_case_t* c) {
+  for (int32_t i = 0; i < c->n; i++) {
+    polyfit_evaluate(c->poly, c->x[i], &c->out[i]);
+  }
+  bench_consume(c->out[c->n - 1]);
+}
+
+static void run_r_squared(bench_case_t* c) {
+  float r2 = 0.0f;
+  polyfit_r_squared(c->poly, c->x, c->y, c->n, &r2);
+  bench_consume(r2);
+}
+
+static void run_best_degree(bench_case_t* c) {
+  int32_t best = 0;
+  Polynomial* p = polyfit_best_degree(c->x, c->y, c->n, c->degree, &best, NULL);
+  bench_consume((float)best);
+  polyfit_free(p);
+}
+
+typedef struct {
+  const char* name;
+  bench_fn_t fn;
+  int32_t min_degree; /**< best_degree needs max_degree >= 1 */
+} bench_def_t;
+
+static const bench_def_t kBenchmarks[] = {
+    {"least_squares", run_least_squares, 0},
+    {"evaluate", run_evaluate, 0},
+    {"r_squared", run_r_squared, 0},
+    {"best_degree", run_best_degree, 1},
+};
+
+int main(int argc, char** argv) {
+  bool json = false;
+  long long max_n = 1000000;
+  double min_time = 0.05;
+  const char* filter = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if (strcmp(argv[i], "--max-n") == 0 && i + 1 < argc) {
+      max_n = atoll(argv[++i]);
+    } else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+      min_time = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--json] [--max-n N] [--min-time SECONDS] "
+              "[--filter SUBSTRING]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  if (max_n < 10 || max_n > INT32_MAX) {
+    fprintf(stderr, "--max-n must be in [10, %d]\n", INT32_MAX);
+    return 2;
+  }
+
+  const int32_t capacity = (int32_t)max_n;
+  float* x = (float*)malloc((size_t)capacity * sizeof(float));
+  float* y = (float*)malloc((size_t)capacity * sizeof(float));
+  float* out = (float*)malloc((size_t)capacity * sizeof(float));
+  if (x == NULL || y == NULL || out == NULL) {
+    fprintf(stderr, "allocation failed\n");
+    return 1;
+  }
+
+  alloc_counter_t counter = {0};
+  polyfit_allocator_t allocator = {counting_alloc, counting_free, &counter};
+  polyfit_set_allocator(&allocator);
+
+  if (json) {
+    printf("{\n  \"context\": {\"max_n\": %lld, \"min_time\": %g, "
+           "\"max_degree\": %d},\n  \"benchmarks\": [",
+           max_n, min_time, POLYFIT_MAX_DEGREE);
+  } else {
+    printf("%-34s %12s %14s %14s %12s\n", "benchmark", "iterations",
+           "ns/point", "calls/s", "allocs/call");
+  }
+
+  bool first_row = true;
+  const int32_t num_defs =
+      (int32_t)(sizeof(kBenchmarks) / sizeof(kBenchmarks[0]));
+  for (int32_t b = 0; b < num_defs; b++) {
+    const bench_def_t* def = &kBenchmarks[b];
+    for (long long n = 10; n <= max_n; n *= 10) {
+      // Same data for every case of a given n
+      bench_fill_data(x, y, (int32_t)n, -1.0f, 1.0f, 42);
+
+      for (int32_t degree = def->min_degree; degree <= POLYFIT_MAX_DEGREE;
+           degree++) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s/n:%lld/degree:%d", def->name, n,
+                 (int)degree);
+        if (filter != NULL && strstr(name, filter) == NULL) {
+          continue;
+        }
+        if (n <= degree) {
+          continue;
+        }
+
+        bench_case_t c = {x, y, out, (int32_t)n, degree, NULL};
+        c.poly = polyfit_init(degree);
+        polyfit_least_squares(x, y, (int32_t)n, degree, c.poly);
+
+        // Warm up, then double the batch until min_time is reached
+        def->fn(&c);
+        int64_t iterations = 0;
+        int64_t batch = 1;
+        int64_t allocs = 0;
+        double elapsed = 0.0;
+        while (elapsed < min_time) {
+          const int64_t before = counter.allocs;
+          const double t0 = bench_now();
+          for (int64_t i = 0; i < batch; i++) {
+            def->fn(&c);
+          }
+          elapsed += bench_now() - t0;
+          allocs += counter.allocs - before;
+          iterations += batch;
+          batch *= 2;
+        }
+
+        const double per_call = elapsed / (double)iterations;
+        const double ns_per_point = per_call * 1e9 / (double)n;
+        const double calls_per_s = 1.0 / per_call;
+        const double allocs_per_call = (double)allocs / (double)iterations;
+
+        if (json) {
+          printf("%s\n    {\"name\": \"%s\", \"function\": \"%s\", "
+                 "\"n\": %lld, \"degree\": %d, \"iterations\": %lld, "
+                 "\"ns_per_point\": %.4f, \"calls_per_second\": %.4e, "
+                 "\"allocs_per_call\": %.3f}",
+                 first_row ? "" : ",", name, def->name, n, (int)degree,
+                 (long long)iterations, ns_per_point, calls_per_s,
+                 allocs_per_call);
+        } else {
+          printf("%-34s %12lld %14.4f %14.4e %12.3f\n", name,
+                 (long long)iterations, ns_per_point, calls_per_s,
+                 allocs_per_call);
+        }
+        fflush(stdout);
+        first_row = false;
+
+        polyfit_free(c.poly);
+      }
+    }
+  }
+
+  if (json) {
+    printf("\n  ]\n}\n");
+  }
+
+  polyfit_set_allocator(NULL);
+  free(x);
+  free(y);
+  free(out);
+  return 0;
+}
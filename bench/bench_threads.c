@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * @file    bench_threads.c
+ * @brief   Scaling of polyfit_compute_moments_parallel with thread count
+ ******************************************************************************
+ * Usage: bench_threads [num_points] [max_threads] [repeats]
+ *
+ * max_threads is capped at POLYFIT_MAX_THREADS, which the library clamps to.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "polyfit.h"
+
+int main(int argc, char** argv) {
+  int32_t n = (argc > 1) ? atoi(argv[1]) : 50000000;
+  int32_t max_threads = (argc > 2) ? atoi(argv[2]) : 8;
+  int32_t repeats = (argc > 3) ? atoi(argv[3]) : 3;
+  const int32_t degree = 3;
+  if (max_threads > POLYFIT_MAX_THREADS) {
+    max_threads = POLYFIT_MAX_THREADS;
+  }
+
+  float* x = (float*)malloc((size_t)n * sizeof(float));
+  float* y = (float*)malloc((size_t)n * sizeof(float));
+  if (x == NULL || y == NULL) {
+    fprintf(stderr, "allocation failed\n");
+    return 1;
+  }
+  bench_fill_data(x, y, n, -1.0f, 1.0f, 42);
+
+  polyfit_moments_t reference;
+  if (polyfit_compute_moments_parallel(x, y, n, degree, 1, &reference) !=
+      POLYFIT_SUCCESS) {
+    fprintf(stderr, "reference accumulation failed\n");
+    return 1;
+  }
+
+  printf("%-8s %12s %16s %8s %10s\n", "threads", "seconds", "pts/s",
+         "speedup", "identical");
+
+  double single = 0.0;
+  for (int32_t threads = 1; threads <= max_threads; threads *= 2) {
+    polyfit_moments_t moments;
+    double t0 = bench_now();
+    for (int32_t r = 0; r < repeats; r++) {
+      polyfit_compute_moments_parallel(x, y, n, degree, threads, &moments);
+      bench_consume((float)moments.power_sums[1]);
+    }
+    double elapsed = (bench_now() - t0) / (double)repeats;
+    if (threads == 1) {
+      single = elapsed;
+    }
+
+    bool identical =
+        memcmp(moments.power_sums, reference.power_sums,
+               sizeof(reference.power_sums)) == 0 &&
+        memcmp(moments.cross_sums, reference.cross_sums,
+               sizeof(reference.cross_sums)) == 0 &&
+        memcmp(&moments.sum_y2, &reference.sum_y2, sizeof(double)) == 0;
+
+    printf("%-8d %12.4f %16.3e %7.2fx %10s\n", threads, elapsed,
+           (double)n / elapsed, single / elapsed, identical ? "yes" : "NO");
+  }
+
+  free(x);
+  free(y);
+  return 0;
+}
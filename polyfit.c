@@ -14,19 +14,203 @@
  */
 
 #include "polyfit.h"
+#include <float.h>
 #include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#if defined(POLYFIT_ENABLE_THREADS)
+#include <pthread.h>
+#endif
+
+#if defined(POLYFIT_ENABLE_STATS)
+#include <time.h>
+#endif
+
+/** @brief Points evaluated per block when a stack buffer is needed */
+#define POLYFIT_BLOCK_SIZE (256)
+
+/** @brief Samples of the curve used to fit an inverse polynomial */
+#define POLYFIT_INVERSE_SAMPLES (512)
+
+/** @brief Iteration cap of the safeguarded Newton solve */
+#define POLYFIT_INVERSE_MAX_ITERATIONS (100)
+
+/** @brief a * b + c, fused when the target has a hardware FMA */
+#if defined(FP_FAST_FMAF)
+#define POLYFIT_FMAF(a, b, c) fmaf((a), (b), (c))
+#else
+#define POLYFIT_FMAF(a, b, c) ((a) * (b) + (c))
+#endif
+
+/*
+ * Instrumentation points. Without POLYFIT_ENABLE_STATS each expands to a
+ * no-op expression, so disabled builds carry no counters, clock reads or
+ * branches on the hot path.
+ */
+#if defined(POLYFIT_ENABLE_STATS)
+#define POLYFIT_STATS_TIMESTAMP(name) const uint64_t name = stats_now_ns()
+#define POLYFIT_STATS_COUNT(field, value) (t_stats.field += (uint64_t)(value))
+#define POLYFIT_STATS_ACCUMULATE(num_points, start) \
+  stats_record_accumulate((num_points), (start))
+#define POLYFIT_STATS_SOLVE(moments, degree, error, build_start, solve_start) \
+  stats_record_solve((moments), (degree), (error), (build_start), (solve_start))
+#else
+#define POLYFIT_STATS_TIMESTAMP(name) ((void)0)
+#define POLYFIT_STATS_COUNT(field, value) ((void)0)
+#define POLYFIT_STATS_ACCUMULATE(num_points, start) ((void)0)
+#define POLYFIT_STATS_SOLVE(moments, degree, error, build_start, solve_start) \
+  ((void)0)
+#endif
+
+/**
+ * @brief State of a greedy breakpoint search
+ */
+typedef struct {
+  const float* x;
+  const float* y;
+  int32_t num_points;
+  int32_t degree;
+  float max_residual;
+  bool continuous; /**< The next segment will be pinned at the knot */
+  bool pinned;     /**< The current segment starts at pin_value */
+  float pin_value;
+  float* coeffs; /**< Scratch coefficients of the candidate */
+} piecewise_greedy_t;
 
 /*============================================================================*/
 /* PRIVATE FUNCTION DECLARATIONS                                             */
 /*============================================================================*/
 
-static polyfit_error_t gaussian_elimination(float** A, float* B, float* x,
+static polyfit_error_t gaussian_elimination(float* A, float* B, float* x,
                                             int32_t n);
-static polyfit_error_t allocate_matrix(float*** matrix, int32_t rows,
-                                       int32_t cols);
-static void free_matrix(float** matrix, int32_t rows);
-static polyfit_error_t validate_input_arrays(const float* x, const float* y,
-                                             int32_t num_points);
+static polyfit_error_t solve_moments(const polyfit_moments_t* moments,
+                                     int32_t degree, float* A, float* B,
+                                     Polynomial* result_poly);
+static polyfit_error_t least_squares_impl(const polyfit_input_t* x,
+                                          const polyfit_input_t* y,
+                                          const polyfit_input_t* w,
+                                          int32_t num_points, int32_t degree,
+                                          const polyfit_config_t* config,
+                                          polyfit_workspace_t* ws,
+                                          Polynomial* result_poly,
+                                          polyfit_quality_t* quality);
+static double moments_rss(const polyfit_moments_t* moments,
+                          const float* coeffs, int32_t degree);
+static void moments_quality(const polyfit_moments_t* moments,
+                            const float* coeffs, int32_t degree,
+                            polyfit_quality_t* quality);
+static void* polyfit_alloc(size_t size);
+static void* polyfit_alloc_zeroed(size_t count, size_t size);
+static void polyfit_dealloc(void* ptr);
+static void* default_alloc(size_t size, void* user_data);
+static void default_free(void* ptr, void* user_data);
+static void set_domain(Polynomial* poly, bool is_normalized, float x_offset,
+                       float x_scale);
+static float horner_eval(const float* coeffs, int32_t degree, float t);
+static float estrin_eval(const float* coeffs, int32_t degree, float t);
+static float poly_eval(const float* coeffs, int32_t degree, float t);
+static void horner_batch(const Polynomial* poly, const float* xs, float* out,
+                         int32_t num_points);
+static void bank_horner(const polyfit_bank_t* bank, const float* xs,
+                        bool shared_x, float* out);
+static polyfit_error_t plan_factor(
+    const float* x, int32_t num_points, int32_t size, double x_offset,
+    double x_scale, double* q,
+    double r[POLYFIT_MAX_DEGREE + 1][POLYFIT_MAX_DEGREE + 1]);
+static void plan_project(const polyfit_plan_t* plan, const float* ys,
+                         int32_t num_series, float* coeffs);
+static void moments_reset(polyfit_moments_t* moments, int32_t degree);
+static void accumulate_moments(polyfit_moments_t* moments, const float* x,
+                               const float* y, int32_t num_points,
+                               double x_offset, double x_scale);
+static void load_input(const polyfit_input_t* in, int32_t start,
+                       int32_t count, double* out);
+static bool input_valid(const polyfit_input_t* in);
+static bool input_has_data(const polyfit_input_t* in);
+static void load_input_float(const polyfit_input_t* in, int32_t start,
+                             int32_t count, float* out);
+static void accumulate_input(polyfit_moments_t* moments,
+                             const polyfit_input_t* x,
+                             const polyfit_input_t* y,
+                             const polyfit_input_t* w, int32_t start,
+                             int32_t num_points, double x_offset,
+                             double x_scale);
+static void accumulate_range(polyfit_moments_t* moments,
+                             const polyfit_input_t* x,
+                             const polyfit_input_t* y,
+                             const polyfit_input_t* w, int32_t start,
+                             int32_t num_points, double x_offset,
+                             double x_scale);
+static polyfit_error_t validate_moments(const polyfit_moments_t* moments);
+static polyfit_error_t accumulate_moments_parallel(
+    polyfit_moments_t* moments, const polyfit_input_t* x,
+    const polyfit_input_t* y, const polyfit_input_t* w, int32_t num_points,
+    double x_offset, double x_scale, int32_t num_threads,
+    const polyfit_allocator_t* allocator);
+static void update_moments(polyfit_moments_t* moments, float x, float y,
+                           double sign);
+static void merge_moments(polyfit_moments_t* dst,
+                          const polyfit_moments_t* src);
+static void window_rebuild(polyfit_window_t* win);
+static void eval_with_derivative(const Polynomial* poly, double x,
+                                 double* value, double* derivative);
+static double inverse_solve(const Polynomial* poly, double y, double lo,
+                            double hi, double f_lo, double guess);
+static void horner_derivatives(const float* coeffs, int32_t degree, float t,
+                               float* value, float* first, float* second);
+static double antiderivative_eval(const Polynomial* poly, double x);
+static int32_t fixed_frac_bits(double bound);
+static int64_t fixed_shift(int64_t value, int32_t shift);
+static polyfit_piecewise_t* piecewise_create(int32_t num_segments,
+                                             int32_t degree);
+static int32_t piecewise_bucket(const polyfit_piecewise_t* pw, float x);
+static void piecewise_build_index(polyfit_piecewise_t* pw);
+static int32_t piecewise_locate(const polyfit_piecewise_t* pw, float x);
+static float piecewise_horner(const polyfit_piecewise_t* pw, int32_t segment,
+                              float x);
+static polyfit_error_t piecewise_solve(const polyfit_moments_t* moments,
+                                       int32_t degree, bool pinned,
+                                       float pin_value, float* coeffs);
+static polyfit_error_t piecewise_fit_range(const float* x, const float* y,
+                                           int32_t start, int32_t count,
+                                           float left, float inv_width,
+                                           int32_t degree, bool pinned,
+                                           float pin_value, float* coeffs,
+                                           float* max_residual);
+static bool piecewise_candidate_fits(const piecewise_greedy_t* g,
+                                     int32_t start, int32_t len);
+static polyfit_error_t piecewise_fit_fixed(
+    const float* x, const float* y, int32_t num_points, int32_t degree,
+    const float* breakpoints, int32_t num_segments, bool continuous,
+    polyfit_piecewise_t** out);
+static polyfit_error_t piecewise_fit_greedy(
+    const float* x, const float* y, int32_t num_points, int32_t degree,
+    float max_residual, int32_t max_segments, bool continuous,
+    polyfit_piecewise_t** out);
+#if defined(POLYFIT_ENABLE_STATS)
+static uint64_t stats_now_ns(void);
+static void stats_record_accumulate(int32_t num_points, uint64_t start);
+static void stats_record_solve(const polyfit_moments_t* moments,
+                               int32_t degree, polyfit_error_t error,
+                               uint64_t build_start, uint64_t solve_start);
+#endif
+
+/** @brief Allocator used when no per-call allocator is given */
+static polyfit_allocator_t g_allocator = {default_alloc, default_free, NULL};
+
+#if defined(POLYFIT_ENABLE_STATS)
+/** @brief Counters of the current thread */
+static _Thread_local polyfit_stats_t t_stats;
+/** @brief Accumulation time not yet reported to the callback */
+static _Thread_local uint64_t t_pending_accumulate_ns;
+static polyfit_stats_callback_t g_stats_callback = NULL;
+static void* g_stats_user_data = NULL;
+#endif
 
 /*============================================================================*/
 /* PUBLIC FUNCTION IMPLEMENTATIONS                                           */
@@ -37,30 +221,31 @@ Polynomial* polyfit_init(int32_t degree) {
     return NULL;
   }
 
-  Polynomial* poly = (Polynomial*)malloc(sizeof(Polynomial));
+  Polynomial* poly = (Polynomial*)polyfit_alloc(sizeof(Polynomial));
   if (poly == NULL) {
     return NULL;
   }
 
-  poly->coefficients = (float*)calloc(degree + 1, sizeof(float));
+  poly->coefficients = (float*)polyfit_alloc_zeroed(degree + 1, sizeof(float));
   if (poly->coefficients == NULL) {
-    free(poly);
+    polyfit_dealloc(poly);
     return NULL;
   }
 
   poly->degree = degree;
   poly->is_valid = true;
+  set_domain(poly, false, 0.0f, 1.0f);
 
   return poly;
 }
 
 void polyfit_free(Polynomial* poly) {
   if (poly != NULL) {
-    free(poly->coefficients);
+    polyfit_dealloc(poly->coefficients);
     poly->coefficients = NULL;
     poly->degree = -1;
     poly->is_valid = false;
-    free(poly);
+    polyfit_dealloc(poly);
   }
 }
 
@@ -80,54 +265,244 @@ polyfit_error_t polyfit_least_squares(const float* x, const float* y,
     return POLYFIT_ERROR_INSUFFICIENT_POINTS;
   }
 
-  polyfit_error_t error = validate_input_arrays(x, y, num_points);
+  // Single pass over the data, then solve from the moments
+  polyfit_moments_t moments;
+  polyfit_error_t error =
+      polyfit_compute_moments(x, y, num_points, degree, &moments);
   if (error != POLYFIT_SUCCESS) {
     return error;
   }
 
-  // Allocate matrices
-  float** A = NULL;
-  float* B = NULL;
+  return polyfit_fit_moments(&moments, degree, result_poly);
+}
+
+polyfit_config_t polyfit_default_config(void) {
+  polyfit_config_t config;
+  config.absolute_threshold = POLYFIT_ABSOLUTE_THRESHOLD;
+  config.relative_threshold = POLYFIT_RELATIVE_THRESHOLD;
+  config.enable_pivot_check = true;
+  config.normalize_domain = false;
+  config.num_threads = 0;
+  config.allocator = NULL;
+  return config;
+}
+
+polyfit_error_t polyfit_least_squares_ex(const float* x, const float* y,
+                                         int32_t num_points, int32_t degree,
+                                         const polyfit_config_t* config,
+                                         Polynomial* result_poly) {
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  return least_squares_impl(&x_in, &y_in, NULL, num_points, degree, config,
+                            NULL, result_poly, NULL);
+}
+
+polyfit_error_t polyfit_least_squares_quality(const float* x, const float* y,
+                                              int32_t num_points,
+                                              int32_t degree,
+                                              const polyfit_config_t* config,
+                                              Polynomial* result_poly,
+                                              polyfit_quality_t* quality) {
+  if (quality == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  return least_squares_impl(&x_in, &y_in, NULL, num_points, degree, config,
+                            NULL, result_poly, quality);
+}
+
+polyfit_error_t polyfit_compute_moments(const float* x, const float* y,
+                                        int32_t num_points, int32_t degree,
+                                        polyfit_moments_t* moments) {
+  if (x == NULL || y == NULL || moments == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  moments_reset(moments, degree);
+  accumulate_moments(moments, x, y, num_points, 0.0, 1.0);
+
+  // Any NaN or infinite input propagates into the sums, so checking them
+  // replaces a separate validation pass over the data
+  return validate_moments(moments);
+}
+
+polyfit_error_t polyfit_compute_moments_parallel(const float* x,
+                                                 const float* y,
+                                                 int32_t num_points,
+                                                 int32_t degree,
+                                                 int32_t num_threads,
+                                                 polyfit_moments_t* moments) {
+  if (x == NULL || y == NULL || moments == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= 0 || num_threads <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
 
-  error = allocate_matrix(&A, degree + 1, degree + 1);
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  moments_reset(moments, degree);
+  polyfit_error_t error = accumulate_moments_parallel(
+      moments, &x_in, &y_in, NULL, num_points, 0.0, 1.0, num_threads, NULL);
   if (error != POLYFIT_SUCCESS) {
     return error;
   }
 
-  B = (float*)calloc(degree + 1, sizeof(float));
-  if (B == NULL) {
-    free_matrix(A, degree + 1);
-    return POLYFIT_ERROR_MEMORY_ALLOC;
+  return validate_moments(moments);
+}
+
+polyfit_input_t polyfit_input(const void* data, polyfit_type_t type) {
+  polyfit_input_t input;
+  input.data = data;
+  input.type = type;
+  input.scale = 1.0;
+  input.offset = 0.0;
+  input.origin = 0;
+  input.stride = 0;
+
+  // The first sample is the chunk-local origin for int64 axes
+  if (type == POLYFIT_TYPE_INT64 && data != NULL) {
+    input.origin = *(const int64_t*)data;
   }
 
-  // Build normal equations (A^T * A * coeffs = A^T * y)
-  for (int32_t i = 0; i <= degree; i++) {
-    for (int32_t j = 0; j <= degree; j++) {
-      A[i][j] = 0.0f;
-      for (int32_t k = 0; k < num_points; k++) {
-        A[i][j] += polyfit_pow(x[k], i + j);
-      }
-    }
+  return input;
+}
 
-    B[i] = 0.0f;
-    for (int32_t k = 0; k < num_points; k++) {
-      B[i] += y[k] * polyfit_pow(x[k], i);
-    }
+polyfit_input_t polyfit_input_index(double x0, double dx) {
+  polyfit_input_t input = polyfit_input(NULL, POLYFIT_TYPE_INDEX);
+  input.scale = dx;
+  input.offset = x0;
+  return input;
+}
+
+polyfit_error_t polyfit_compute_moments_typed(const polyfit_input_t* x,
+                                              const polyfit_input_t* y,
+                                              int32_t num_points,
+                                              int32_t degree,
+                                              polyfit_moments_t* moments) {
+  if (x == NULL || y == NULL || !input_has_data(x) || !input_has_data(y) ||
+      moments == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
   }
 
-  // Solve the system
-  error = gaussian_elimination(A, B, result_poly->coefficients, degree + 1);
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= 0 || !input_valid(x) || !input_valid(y)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
 
-  // Cleanup
-  free_matrix(A, degree + 1);
-  free(B);
+  moments_reset(moments, degree);
+  accumulate_input(moments, x, y, NULL, 0, num_points, 0.0, 1.0);
 
-  if (error == POLYFIT_SUCCESS) {
-    result_poly->degree = degree;
-    result_poly->is_valid = true;
+  return validate_moments(moments);
+}
+
+polyfit_error_t polyfit_least_squares_typed(const polyfit_input_t* x,
+                                            const polyfit_input_t* y,
+                                            int32_t num_points,
+                                            int32_t degree,
+                                            const polyfit_config_t* config,
+                                            Polynomial* result_poly) {
+  return least_squares_impl(x, y, NULL, num_points, degree, config, NULL,
+                            result_poly, NULL);
+}
+
+polyfit_error_t polyfit_compute_moments_weighted(const float* x,
+                                                 const float* y,
+                                                 const float* w,
+                                                 int32_t num_points,
+                                                 int32_t degree,
+                                                 polyfit_moments_t* moments) {
+  if (x == NULL || y == NULL || w == NULL || moments == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
   }
 
-  return error;
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t w_in = polyfit_input(w, POLYFIT_TYPE_FLOAT);
+  moments_reset(moments, degree);
+  accumulate_input(moments, &x_in, &y_in, &w_in, 0, num_points, 0.0, 1.0);
+
+  return validate_moments(moments);
+}
+
+polyfit_error_t polyfit_least_squares_weighted(const float* x, const float* y,
+                                               const float* w,
+                                               int32_t num_points,
+                                               int32_t degree,
+                                               const polyfit_config_t* config,
+                                               Polynomial* result_poly) {
+  if (w == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t w_in = polyfit_input(w, POLYFIT_TYPE_FLOAT);
+  return least_squares_impl(&x_in, &y_in, &w_in, num_points, degree, config,
+                            NULL, result_poly, NULL);
+}
+
+polyfit_error_t polyfit_moments_merge(polyfit_moments_t* dst,
+                                      const polyfit_moments_t* src) {
+  if (dst == NULL || src == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (dst->degree != src->degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  merge_moments(dst, src);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_fit_moments(const polyfit_moments_t* moments,
+                                    int32_t degree, Polynomial* result_poly) {
+  if (moments == NULL || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > moments->degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (moments->num_points <= degree) {
+    return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  // The system is at most (POLYFIT_MAX_DEGREE+1)^2, so it lives on the stack
+  float A[(POLYFIT_MAX_DEGREE + 1) * (POLYFIT_MAX_DEGREE + 1)];
+  float B[POLYFIT_MAX_DEGREE + 1];
+
+  return solve_moments(moments, degree, A, B, result_poly);
 }
 
 polyfit_error_t polyfit_evaluate(const Polynomial* poly, float x,
@@ -140,13 +515,65 @@ polyfit_error_t polyfit_evaluate(const Polynomial* poly, float x,
     return POLYFIT_ERROR_INVALID_INPUT;
   }
 
-  *result = 0.0f;
+  if (poly->is_normalized) {
+    x = (x - poly->x_offset) * poly->x_scale;
+  }
+
+  *result = poly_eval(poly->coefficients, poly->degree, x);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_evaluate_horner(const Polynomial* poly, float x,
+                                        float* result) {
+  if (poly == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (poly->is_normalized) {
+    x = (x - poly->x_offset) * poly->x_scale;
+  }
+
+  *result = horner_eval(poly->coefficients, poly->degree, x);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_evaluate_estrin(const Polynomial* poly, float x,
+                                        float* result) {
+  if (poly == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (poly->is_normalized) {
+    x = (x - poly->x_offset) * poly->x_scale;
+  }
+
+  *result = estrin_eval(poly->coefficients, poly->degree, x);
 
-  // Use Horner's method for efficient evaluation
-  for (int32_t i = poly->degree; i >= 0; i--) {
-    *result = *result * x + poly->coefficients[i];
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_evaluate_batch(const Polynomial* poly, const float* xs,
+                                       float* out, int32_t num_points) {
+  if (poly == NULL || xs == NULL || out == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
   }
 
+  if (!polyfit_is_valid(poly) || num_points < 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  horner_batch(poly, xs, out, num_points);
+
   return POLYFIT_SUCCESS;
 }
 
@@ -172,6 +599,40 @@ polyfit_error_t polyfit_get_max_coefficient_magnitude(const Polynomial* poly,
   return POLYFIT_SUCCESS;
 }
 
+polyfit_error_t polyfit_denormalize(Polynomial* poly) {
+  if (poly == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (!poly->is_normalized) {
+    return POLYFIT_SUCCESS;
+  }
+
+  // p((x - offset) * scale): fold in the scale, then Taylor shift by -offset
+  const int32_t degree = poly->degree;
+  float* c = poly->coefficients;
+  float scale_power = 1.0f;
+  for (int32_t i = 0; i <= degree; i++) {
+    c[i] *= scale_power;
+    scale_power *= poly->x_scale;
+  }
+
+  const float shift = -poly->x_offset;
+  for (int32_t i = 0; i < degree; i++) {
+    for (int32_t j = degree - 1; j >= i; j--) {
+      c[j] += shift * c[j + 1];
+    }
+  }
+
+  set_domain(poly, false, 0.0f, 1.0f);
+
+  return POLYFIT_SUCCESS;
+}
+
 bool polyfit_is_valid(const Polynomial* poly) {
   return (poly != NULL && poly->coefficients != NULL && poly->degree >= 0 &&
           poly->degree <= POLYFIT_MAX_DEGREE && poly->is_valid);
@@ -241,19 +702,15 @@ polyfit_error_t polyfit_eval_at(const float* x, const float* y,
   }
 
   // Fit the polynomial
-  polyfit_error_t error;
-  Polynomial* poly = polyfit(x, y, num_points, degree, &error);
-  if (poly == NULL) {
+  polyfit_static_poly_t poly;
+  polyfit_error_t error =
+      polyfit_static_fit(x, y, num_points, degree, NULL, &poly);
+  if (error != POLYFIT_SUCCESS) {
     return error;
   }
 
   // Evaluate at the specified point
-  error = polyfit_evaluate(poly, eval_x, result);
-
-  // Clean up
-  polyfit_free(poly);
-
-  return error;
+  return polyfit_static_evaluate(&poly, eval_x, result);
 }
 
 polyfit_error_t polyfit_get_coefficients(const Polynomial* poly, float* coeffs,
@@ -282,6 +739,49 @@ polyfit_error_t polyfit_get_coefficients(const Polynomial* poly, float* coeffs,
 /* FIT QUALITY AND AUTO-DEGREE IMPLEMENTATIONS                               */
 /*============================================================================*/
 
+polyfit_error_t polyfit_moments_rss(const polyfit_moments_t* moments,
+                                    const Polynomial* poly, double* rss) {
+  if (moments == NULL || poly == NULL || rss == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly) || poly->is_normalized) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (poly->degree > moments->degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  *rss = moments_rss(moments, poly->coefficients, poly->degree);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_moments_quality(const polyfit_moments_t* moments,
+                                        const Polynomial* poly,
+                                        polyfit_quality_t* quality) {
+  if (moments == NULL || poly == NULL || quality == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly) || poly->is_normalized) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (poly->degree > moments->degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (moments->num_points <= 0) {
+    return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  moments_quality(moments, poly->coefficients, poly->degree, quality);
+
+  return POLYFIT_SUCCESS;
+}
+
 polyfit_error_t polyfit_compute_residuals(const Polynomial* poly,
                                           const float* x, const float* y,
                                           int32_t num_points,
@@ -298,13 +798,9 @@ polyfit_error_t polyfit_compute_residuals(const Polynomial* poly,
     return POLYFIT_ERROR_INVALID_INPUT;
   }
 
+  horner_batch(poly, x, residuals, num_points);
   for (int32_t i = 0; i < num_points; i++) {
-    float y_hat;
-    polyfit_error_t err = polyfit_evaluate(poly, x[i], &y_hat);
-    if (err != POLYFIT_SUCCESS) {
-      return err;
-    }
-    residuals[i] = y_hat - y[i];
+    residuals[i] -= y[i];
   }
 
   return POLYFIT_SUCCESS;
@@ -335,17 +831,21 @@ polyfit_error_t polyfit_r_squared(const Polynomial* poly, const float* x,
   // Compute total and residual sums of squares
   float ss_tot = 0.0f;
   float ss_res = 0.0f;
+  float y_hat[POLYFIT_BLOCK_SIZE];
 
-  for (int32_t i = 0; i < num_points; i++) {
-    float y_hat;
-    polyfit_error_t err = polyfit_evaluate(poly, x[i], &y_hat);
-    if (err != POLYFIT_SUCCESS) {
-      return err;
+  for (int32_t start = 0; start < num_points; start += POLYFIT_BLOCK_SIZE) {
+    int32_t count = num_points - start;
+    if (count > POLYFIT_BLOCK_SIZE) {
+      count = POLYFIT_BLOCK_SIZE;
+    }
+
+    horner_batch(poly, x + start, y_hat, count);
+    for (int32_t i = 0; i < count; i++) {
+      float diff_res = y_hat[i] - y[start + i];
+      float diff_tot = y[start + i] - y_mean;
+      ss_res += diff_res * diff_res;
+      ss_tot += diff_tot * diff_tot;
     }
-    float diff_res = y_hat - y[i];
-    float diff_tot = y[i] - y_mean;
-    ss_res += diff_res * diff_res;
-    ss_tot += diff_tot * diff_tot;
   }
 
   if (ss_tot < 1e-20f) {
@@ -358,257 +858,3676 @@ polyfit_error_t polyfit_r_squared(const Polynomial* poly, const float* x,
   return POLYFIT_SUCCESS;
 }
 
-Polynomial* polyfit_best_degree(const float* x, const float* y,
-                                int32_t num_points, int32_t max_degree,
-                                int32_t* best_degree,
-                                polyfit_error_t* error) {
-  if (x == NULL || y == NULL || best_degree == NULL) {
-    if (error != NULL) {
-      *error = POLYFIT_ERROR_NULL_POINTER;
-    }
-    return NULL;
+polyfit_error_t polyfit_compute_residuals_typed(const Polynomial* poly,
+                                                const polyfit_input_t* x,
+                                                const polyfit_input_t* y,
+                                                int32_t num_points,
+                                                float* residuals) {
+  if (poly == NULL || x == NULL || y == NULL || residuals == NULL ||
+      !input_has_data(x) || !input_has_data(y)) {
+    return POLYFIT_ERROR_NULL_POINTER;
   }
 
-  if (max_degree < 1 || max_degree > POLYFIT_MAX_DEGREE) {
-    if (error != NULL) {
-      *error = POLYFIT_ERROR_INVALID_DEGREE;
-    }
-    return NULL;
+  if (!polyfit_is_valid(poly) || !input_valid(x) || !input_valid(y)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
   }
 
-  if (num_points <= max_degree) {
-    if (error != NULL) {
-      *error = POLYFIT_ERROR_INSUFFICIENT_POINTS;
-    }
-    return NULL;
+  if (num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
   }
 
-  Polynomial* best_poly = NULL;
-  float best_bic = 0.0f;
-  float fn = (float)num_points;
+  float xb[POLYFIT_BLOCK_SIZE];
+  float yb[POLYFIT_BLOCK_SIZE];
 
-  for (int32_t d = 1; d <= max_degree; d++) {
-    polyfit_error_t local_err;
-    Polynomial* poly = polyfit(x, y, num_points, d, &local_err);
-    if (poly == NULL) {
-      continue;
+  for (int32_t start = 0; start < num_points; start += POLYFIT_BLOCK_SIZE) {
+    int32_t count = num_points - start;
+    if (count > POLYFIT_BLOCK_SIZE) {
+      count = POLYFIT_BLOCK_SIZE;
     }
 
-    // Compute residual sum of squares
-    float ss_res = 0.0f;
-    for (int32_t i = 0; i < num_points; i++) {
-      float y_hat;
-      if (polyfit_evaluate(poly, x[i], &y_hat) == POLYFIT_SUCCESS) {
-        float diff = y_hat - y[i];
-        ss_res += diff * diff;
-      }
+    load_input_float(x, start, count, xb);
+    load_input_float(y, start, count, yb);
+    horner_batch(poly, xb, residuals + start, count);
+    for (int32_t i = 0; i < count; i++) {
+      residuals[start + i] -= yb[i];
     }
+  }
 
-    // BIC = n * ln(RSS/n) + (d+1) * ln(n)
-    float bic;
-    if (ss_res < 1e-30f) {
-      bic = -1e30f;  // Near-perfect fit
-    } else {
-      bic = fn * logf(ss_res / fn) + (float)(d + 1) * logf(fn);
-    }
+  return POLYFIT_SUCCESS;
+}
 
-    if (best_poly == NULL || bic < best_bic) {
-      best_bic = bic;
-      *best_degree = d;
-      polyfit_free(best_poly);
-      best_poly = poly;
-    } else {
-      polyfit_free(poly);
-    }
+polyfit_error_t polyfit_r_squared_typed(const Polynomial* poly,
+                                        const polyfit_input_t* x,
+                                        const polyfit_input_t* y,
+                                        int32_t num_points,
+                                        float* r_squared) {
+  if (poly == NULL || x == NULL || y == NULL || r_squared == NULL ||
+      !input_has_data(x) || !input_has_data(y)) {
+    return POLYFIT_ERROR_NULL_POINTER;
   }
 
-  if (best_poly == NULL) {
-    if (error != NULL) {
+  if (!polyfit_is_valid(poly) || !input_valid(x) || !input_valid(y)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  float xb[POLYFIT_BLOCK_SIZE];
+  float yb[POLYFIT_BLOCK_SIZE];
+  float y_hat[POLYFIT_BLOCK_SIZE];
+
+  // Compute mean of y
+  float y_mean = 0.0f;
+  for (int32_t start = 0; start < num_points; start += POLYFIT_BLOCK_SIZE) {
+    int32_t count = num_points - start;
+    if (count > POLYFIT_BLOCK_SIZE) {
+      count = POLYFIT_BLOCK_SIZE;
+    }
+
+    load_input_float(y, start, count, yb);
+    for (int32_t i = 0; i < count; i++) {
+      y_mean += yb[i];
+    }
+  }
+  y_mean /= (float)num_points;
+
+  // Compute total and residual sums of squares
+  float ss_tot = 0.0f;
+  float ss_res = 0.0f;
+
+  for (int32_t start = 0; start < num_points; start += POLYFIT_BLOCK_SIZE) {
+    int32_t count = num_points - start;
+    if (count > POLYFIT_BLOCK_SIZE) {
+      count = POLYFIT_BLOCK_SIZE;
+    }
+
+    load_input_float(x, start, count, xb);
+    load_input_float(y, start, count, yb);
+    horner_batch(poly, xb, y_hat, count);
+    for (int32_t i = 0; i < count; i++) {
+      float diff_res = y_hat[i] - yb[i];
+      float diff_tot = yb[i] - y_mean;
+      ss_res += diff_res * diff_res;
+      ss_tot += diff_tot * diff_tot;
+    }
+  }
+
+  if (ss_tot < 1e-20f) {
+    *r_squared = (ss_res < 1e-20f) ? 1.0f : 0.0f;
+    return POLYFIT_SUCCESS;
+  }
+
+  *r_squared = 1.0f - (ss_res / ss_tot);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_compute_residuals_weighted(const Polynomial* poly,
+                                                   const float* x,
+                                                   const float* y,
+                                                   const float* w,
+                                                   int32_t num_points,
+                                                   float* residuals) {
+  if (poly == NULL || x == NULL || y == NULL || w == NULL ||
+      residuals == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  // Check every weight before the output is touched
+  for (int32_t i = 0; i < num_points; i++) {
+    if (!(w[i] >= 0.0f)) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+  }
+
+  polyfit_error_t error =
+      polyfit_compute_residuals(poly, x, y, num_points, residuals);
+  if (error != POLYFIT_SUCCESS) {
+    return error;
+  }
+
+  for (int32_t i = 0; i < num_points; i++) {
+    residuals[i] *= sqrtf(w[i]);
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_r_squared_weighted(const Polynomial* poly,
+                                           const float* x, const float* y,
+                                           const float* w, int32_t num_points,
+                                           float* r_squared) {
+  if (poly == NULL || x == NULL || y == NULL || w == NULL ||
+      r_squared == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  // Compute weighted mean of y
+  float sum_w = 0.0f;
+  float y_mean = 0.0f;
+  for (int32_t i = 0; i < num_points; i++) {
+    if (!(w[i] >= 0.0f)) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+    sum_w += w[i];
+    y_mean += w[i] * y[i];
+  }
+  if (sum_w <= 0.0f) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+  y_mean /= sum_w;
+
+  // Compute weighted total and residual sums of squares
+  float ss_tot = 0.0f;
+  float ss_res = 0.0f;
+  float y_hat[POLYFIT_BLOCK_SIZE];
+
+  for (int32_t start = 0; start < num_points; start += POLYFIT_BLOCK_SIZE) {
+    int32_t count = num_points - start;
+    if (count > POLYFIT_BLOCK_SIZE) {
+      count = POLYFIT_BLOCK_SIZE;
+    }
+
+    horner_batch(poly, x + start, y_hat, count);
+    for (int32_t i = 0; i < count; i++) {
+      float wi = w[start + i];
+      float diff_res = y_hat[i] - y[start + i];
+      float diff_tot = y[start + i] - y_mean;
+      ss_res += wi * diff_res * diff_res;
+      ss_tot += wi * diff_tot * diff_tot;
+    }
+  }
+
+  if (ss_tot < 1e-20f) {
+    *r_squared = (ss_res < 1e-20f) ? 1.0f : 0.0f;
+    return POLYFIT_SUCCESS;
+  }
+
+  *r_squared = 1.0f - (ss_res / ss_tot);
+
+  return POLYFIT_SUCCESS;
+}
+
+Polynomial* polyfit_best_degree(const float* x, const float* y,
+                                int32_t num_points, int32_t max_degree,
+                                int32_t* best_degree,
+                                polyfit_error_t* error) {
+  if (x == NULL || y == NULL || best_degree == NULL) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+
+  if (max_degree < 1 || max_degree > POLYFIT_MAX_DEGREE) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_INVALID_DEGREE;
+    }
+    return NULL;
+  }
+
+  if (num_points <= max_degree) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_INSUFFICIENT_POINTS;
+    }
+    return NULL;
+  }
+
+  // One pass over the data; every candidate degree is scored from this
+  polyfit_moments_t moments;
+  polyfit_error_t local_err =
+      polyfit_compute_moments(x, y, num_points, max_degree, &moments);
+  if (local_err != POLYFIT_SUCCESS) {
+    if (error != NULL) {
+      *error = local_err;
+    }
+    return NULL;
+  }
+
+  return polyfit_best_degree_moments(&moments, max_degree, 0, best_degree,
+                                     error);
+}
+
+Polynomial* polyfit_best_degree_weighted(const float* x, const float* y,
+                                         const float* w, int32_t num_points,
+                                         int32_t max_degree,
+                                         int32_t* best_degree,
+                                         polyfit_error_t* error) {
+  if (x == NULL || y == NULL || w == NULL || best_degree == NULL) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+
+  if (max_degree < 1 || max_degree > POLYFIT_MAX_DEGREE) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_INVALID_DEGREE;
+    }
+    return NULL;
+  }
+
+  if (num_points <= max_degree) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_INSUFFICIENT_POINTS;
+    }
+    return NULL;
+  }
+
+  polyfit_moments_t moments;
+  polyfit_error_t local_err = polyfit_compute_moments_weighted(
+      x, y, w, num_points, max_degree, &moments);
+  if (local_err != POLYFIT_SUCCESS) {
+    if (error != NULL) {
+      *error = local_err;
+    }
+    return NULL;
+  }
+
+  return polyfit_best_degree_moments(&moments, max_degree, 0, best_degree,
+                                     error);
+}
+
+Polynomial* polyfit_best_degree_moments(const polyfit_moments_t* moments,
+                                        int32_t max_degree, int32_t patience,
+                                        int32_t* best_degree,
+                                        polyfit_error_t* error) {
+  if (moments == NULL || best_degree == NULL) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_NULL_POINTER;
+    }
+    return NULL;
+  }
+
+  if (max_degree < 1 || max_degree > moments->degree) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_INVALID_DEGREE;
+    }
+    return NULL;
+  }
+
+  if (moments->num_points <= max_degree) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_INSUFFICIENT_POINTS;
+    }
+    return NULL;
+  }
+
+  float best_coeffs[POLYFIT_MAX_DEGREE + 1];
+  int32_t best_d = -1;
+  float best_bic = 0.0f;
+  int32_t since_improvement = 0;
+  float fn = (float)moments->num_points;
+
+  // A float fit cannot resolve residuals below float precision of y, so
+  // smaller RSS values are rounding noise and must not win on BIC
+  const double rss_floor =
+      moments->sum_y2 * (double)FLT_EPSILON * (double)FLT_EPSILON;
+
+  for (int32_t d = 1; d <= max_degree; d++) {
+    float coeffs[POLYFIT_MAX_DEGREE + 1];
+    Polynomial poly = {.coefficients = coeffs, .degree = d, .is_valid = true};
+    if (polyfit_fit_moments(moments, d, &poly) != POLYFIT_SUCCESS) {
+      continue;
+    }
+
+    // Residual sum of squares straight from the moments
+    const double rss = moments_rss(moments, coeffs, d);
+    float ss_res = (float)((rss > rss_floor) ? rss : rss_floor);
+
+    // BIC = n * ln(RSS/n) + (d+1) * ln(n)
+    float bic;
+    if (ss_res < 1e-30f) {
+      bic = -1e30f;  // Near-perfect fit
+    } else {
+      bic = fn * logf(ss_res / fn) + (float)(d + 1) * logf(fn);
+    }
+
+    if (best_d < 0 || bic < best_bic) {
+      best_bic = bic;
+      best_d = d;
+      for (int32_t i = 0; i <= d; i++) {
+        best_coeffs[i] = coeffs[i];
+      }
+      since_improvement = 0;
+    } else if (patience > 0 && ++since_improvement >= patience) {
+      break;
+    }
+  }
+
+  if (best_d < 0) {
+    if (error != NULL) {
       *error = POLYFIT_ERROR_SINGULAR_MATRIX;
     }
-    return NULL;
+    return NULL;
+  }
+
+  Polynomial* best_poly = polyfit_init(best_d);
+  if (best_poly == NULL) {
+    if (error != NULL) {
+      *error = POLYFIT_ERROR_MEMORY_ALLOC;
+    }
+    return NULL;
+  }
+
+  for (int32_t i = 0; i <= best_d; i++) {
+    best_poly->coefficients[i] = best_coeffs[i];
+  }
+  *best_degree = best_d;
+
+  if (error != NULL) {
+    *error = POLYFIT_SUCCESS;
+  }
+
+  return best_poly;
+}
+
+/*============================================================================*/
+/* INCREMENTAL FITTING IMPLEMENTATIONS                                       */
+/*============================================================================*/
+
+polyfit_error_t polyfit_accumulator_init(polyfit_accumulator_t* acc,
+                                         int32_t degree) {
+  if (acc == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  moments_reset(&acc->moments, degree);
+  for (int32_t i = 0; i <= POLYFIT_MAX_DEGREE; i++) {
+    acc->coefficients[i] = 0.0f;
+  }
+  acc->is_dirty = true;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_accumulator_reset(polyfit_accumulator_t* acc) {
+  if (acc == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  return polyfit_accumulator_init(acc, acc->moments.degree);
+}
+
+polyfit_error_t polyfit_accumulator_add_point(polyfit_accumulator_t* acc,
+                                              float x, float y) {
+  if (acc == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (x - x != 0.0f || y - y != 0.0f) {  // NaN and Inf check
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  update_moments(&acc->moments, x, y, 1.0);
+  acc->moments.num_points++;
+  acc->is_dirty = true;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_accumulator_add_points(polyfit_accumulator_t* acc,
+                                               const float* x, const float* y,
+                                               int32_t num_points) {
+  if (acc == NULL || x == NULL || y == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  // Accumulate separately so a bad batch leaves the accumulator untouched
+  polyfit_moments_t batch;
+  moments_reset(&batch, acc->moments.degree);
+  accumulate_moments(&batch, x, y, num_points, 0.0, 1.0);
+
+  polyfit_error_t error = validate_moments(&batch);
+  if (error != POLYFIT_SUCCESS) {
+    return error;
+  }
+
+  merge_moments(&acc->moments, &batch);
+  acc->is_dirty = true;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_accumulator_remove_point(polyfit_accumulator_t* acc,
+                                                 float x, float y) {
+  if (acc == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (acc->moments.num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (x - x != 0.0f || y - y != 0.0f) {  // NaN and Inf check
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (acc->moments.num_points == 1) {
+    // Last point gone: reset exactly rather than keep rounding residue
+    moments_reset(&acc->moments, acc->moments.degree);
+  } else {
+    update_moments(&acc->moments, x, y, -1.0);
+    acc->moments.num_points--;
+  }
+  acc->is_dirty = true;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_accumulator_solve(polyfit_accumulator_t* acc,
+                                          Polynomial* result_poly) {
+  if (acc == NULL || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const int32_t degree = acc->moments.degree;
+
+  if (acc->is_dirty) {
+    Polynomial cached = {.coefficients = acc->coefficients,
+                         .degree = degree,
+                         .is_valid = true};
+    polyfit_error_t error = polyfit_fit_moments(&acc->moments, degree, &cached);
+    if (error != POLYFIT_SUCCESS) {
+      return error;
+    }
+    acc->is_dirty = false;
+  }
+
+  for (int32_t i = 0; i <= degree; i++) {
+    result_poly->coefficients[i] = acc->coefficients[i];
+  }
+  result_poly->degree = degree;
+  result_poly->is_valid = true;
+  set_domain(result_poly, false, 0.0f, 1.0f);
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* SLIDING WINDOW IMPLEMENTATIONS                                            */
+/*============================================================================*/
+
+polyfit_window_t* polyfit_window_create(int32_t capacity, int32_t degree) {
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE || capacity <= degree) {
+    return NULL;
+  }
+
+  polyfit_window_t* win =
+      (polyfit_window_t*)polyfit_alloc(sizeof(polyfit_window_t));
+  if (win == NULL) {
+    return NULL;
+  }
+
+  win->x_values = (float*)polyfit_alloc_zeroed(capacity, sizeof(float));
+  win->y_values = (float*)polyfit_alloc_zeroed(capacity, sizeof(float));
+  if (win->x_values == NULL || win->y_values == NULL) {
+    polyfit_dealloc(win->x_values);
+    polyfit_dealloc(win->y_values);
+    polyfit_dealloc(win);
+    return NULL;
+  }
+
+  win->capacity = capacity;
+  win->count = 0;
+  win->head = 0;
+  win->since_rebuild = 0;
+  win->x_origin = 0.0f;
+  polyfit_accumulator_init(&win->acc, degree);
+
+  return win;
+}
+
+void polyfit_window_free(polyfit_window_t* win) {
+  if (win != NULL) {
+    polyfit_dealloc(win->x_values);
+    polyfit_dealloc(win->y_values);
+    win->x_values = NULL;
+    win->y_values = NULL;
+    polyfit_dealloc(win);
+  }
+}
+
+polyfit_error_t polyfit_window_push(polyfit_window_t* win, float x, float y) {
+  if (win == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (x - x != 0.0f || y - y != 0.0f) {  // NaN and Inf check
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (win->count == 0) {
+    // Anchor the origin at the first sample so the shifted x starts near zero
+    win->x_origin = x;
+  }
+
+  int32_t slot;
+  if (win->count == win->capacity) {
+    slot = win->head;
+    polyfit_accumulator_remove_point(
+        &win->acc, win->x_values[slot] - win->x_origin, win->y_values[slot]);
+    win->head = (win->head + 1) % win->capacity;
+  } else {
+    slot = (win->head + win->count) % win->capacity;
+    win->count++;
+  }
+
+  win->x_values[slot] = x;
+  win->y_values[slot] = y;
+  polyfit_accumulator_add_point(&win->acc, x - win->x_origin, y);
+
+  // Re-center once per window turnover; amortised this stays O(degree)
+  win->since_rebuild++;
+  if (win->since_rebuild >= win->capacity) {
+    window_rebuild(win);
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_window_solve(polyfit_window_t* win,
+                                     Polynomial* result_poly,
+                                     float* newest_value) {
+  if (win == NULL || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const int32_t degree = win->acc.moments.degree;
+  float local[POLYFIT_MAX_DEGREE + 1];
+  Polynomial local_poly = {.coefficients = local,
+                           .degree = degree,
+                           .is_valid = true};
+
+  polyfit_error_t error = polyfit_accumulator_solve(&win->acc, &local_poly);
+  if (error != POLYFIT_SUCCESS) {
+    return error;
+  }
+
+  if (newest_value != NULL) {
+    int32_t newest = (win->head + win->count - 1) % win->capacity;
+    polyfit_evaluate(&local_poly, win->x_values[newest] - win->x_origin,
+                     newest_value);
+  }
+
+  // Coefficients stay relative to the window origin; the shift goes into
+  // the polynomial's domain instead of being expanded into them
+  for (int32_t i = 0; i <= degree; i++) {
+    result_poly->coefficients[i] = local[i];
+  }
+  result_poly->degree = degree;
+  result_poly->is_valid = true;
+  set_domain(result_poly, true, win->x_origin, 1.0f);
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* MODEL BANK IMPLEMENTATIONS                                                */
+/*============================================================================*/
+
+polyfit_bank_t* polyfit_bank_create(int32_t num_models, int32_t max_degree) {
+  if (num_models <= 0 || max_degree < 0 || max_degree > POLYFIT_MAX_DEGREE) {
+    return NULL;
+  }
+
+  polyfit_bank_t* bank = (polyfit_bank_t*)polyfit_alloc(sizeof(polyfit_bank_t));
+  if (bank == NULL) {
+    return NULL;
+  }
+
+  // Pad rows to a whole number of 16-lane vectors; the domain offsets and
+  // scales are two extra rows of the same block
+  bank->stride = (num_models + 15) & ~15;
+  bank->coefficients =
+      (float*)polyfit_alloc_zeroed((size_t)(max_degree + 3) * bank->stride,
+                                   sizeof(float));
+  if (bank->coefficients == NULL) {
+    polyfit_dealloc(bank);
+    return NULL;
+  }
+
+  bank->x_offsets = bank->coefficients + (size_t)(max_degree + 1) * bank->stride;
+  bank->x_scales = bank->x_offsets + bank->stride;
+  for (int32_t m = 0; m < bank->stride; m++) {
+    bank->x_scales[m] = 1.0f;
+  }
+
+  bank->num_models = num_models;
+  bank->max_degree = max_degree;
+
+  return bank;
+}
+
+polyfit_bank_t* polyfit_bank_create_from(const Polynomial* const* polys,
+                                         int32_t num_models) {
+  if (polys == NULL || num_models <= 0) {
+    return NULL;
+  }
+
+  int32_t max_degree = 0;
+  for (int32_t m = 0; m < num_models; m++) {
+    if (!polyfit_is_valid(polys[m])) {
+      return NULL;
+    }
+    if (polys[m]->degree > max_degree) {
+      max_degree = polys[m]->degree;
+    }
+  }
+
+  polyfit_bank_t* bank = polyfit_bank_create(num_models, max_degree);
+  if (bank == NULL) {
+    return NULL;
+  }
+
+  for (int32_t m = 0; m < num_models; m++) {
+    polyfit_bank_set(bank, m, polys[m]);
+  }
+
+  return bank;
+}
+
+void polyfit_bank_free(polyfit_bank_t* bank) {
+  if (bank != NULL) {
+    polyfit_dealloc(bank->coefficients);
+    bank->coefficients = NULL;
+    bank->x_offsets = NULL;
+    bank->x_scales = NULL;
+    polyfit_dealloc(bank);
+  }
+}
+
+polyfit_error_t polyfit_bank_set(polyfit_bank_t* bank, int32_t index,
+                                 const Polynomial* poly) {
+  if (bank == NULL || poly == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  polyfit_error_t error = polyfit_bank_set_coefficients(
+      bank, index, poly->coefficients, poly->degree);
+  if (error == POLYFIT_SUCCESS && poly->is_normalized) {
+    bank->x_offsets[index] = poly->x_offset;
+    bank->x_scales[index] = poly->x_scale;
+  }
+
+  return error;
+}
+
+polyfit_error_t polyfit_bank_set_coefficients(polyfit_bank_t* bank,
+                                              int32_t index,
+                                              const float* coeffs,
+                                              int32_t degree) {
+  if (bank == NULL || coeffs == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > bank->max_degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (index < 0 || index >= bank->num_models) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  for (int32_t k = 0; k <= bank->max_degree; k++) {
+    bank->coefficients[(size_t)k * bank->stride + index] =
+        (k <= degree) ? coeffs[k] : 0.0f;
+  }
+  bank->x_offsets[index] = 0.0f;
+  bank->x_scales[index] = 1.0f;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_bank_evaluate_shared(const polyfit_bank_t* bank,
+                                             float x, float* out) {
+  if (bank == NULL || out == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  bank_horner(bank, &x, true, out);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_bank_evaluate_each(const polyfit_bank_t* bank,
+                                           const float* xs, float* out) {
+  if (bank == NULL || xs == NULL || out == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  bank_horner(bank, xs, false, out);
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* PIECEWISE POLYNOMIAL IMPLEMENTATIONS                                      */
+/*============================================================================*/
+
+polyfit_piecewise_t* polyfit_piecewise_fit(const float* x, const float* y,
+                                           int32_t num_points, int32_t degree,
+                                           const float* breakpoints,
+                                           int32_t num_segments,
+                                           bool continuous,
+                                           polyfit_error_t* error) {
+  polyfit_piecewise_t* pw = NULL;
+  polyfit_error_t local_error =
+      piecewise_fit_fixed(x, y, num_points, degree, breakpoints, num_segments,
+                          continuous, &pw);
+  if (error != NULL) {
+    *error = local_error;
+  }
+
+  return pw;
+}
+
+polyfit_piecewise_t* polyfit_piecewise_fit_auto(const float* x, const float* y,
+                                                int32_t num_points,
+                                                int32_t degree,
+                                                float max_residual,
+                                                int32_t max_segments,
+                                                bool continuous,
+                                                polyfit_error_t* error) {
+  polyfit_piecewise_t* pw = NULL;
+  polyfit_error_t local_error =
+      piecewise_fit_greedy(x, y, num_points, degree, max_residual,
+                           max_segments, continuous, &pw);
+  if (error != NULL) {
+    *error = local_error;
+  }
+
+  return pw;
+}
+
+void polyfit_piecewise_free(polyfit_piecewise_t* pw) {
+  if (pw != NULL) {
+    polyfit_dealloc(pw->coefficients);
+    polyfit_dealloc(pw->buckets);
+    pw->coefficients = NULL;
+    pw->breakpoints = NULL;
+    pw->inv_widths = NULL;
+    pw->buckets = NULL;
+    polyfit_dealloc(pw);
+  }
+}
+
+int32_t polyfit_piecewise_segment(const polyfit_piecewise_t* pw, float x) {
+  if (pw == NULL) {
+    return -1;
+  }
+
+  return piecewise_locate(pw, x);
+}
+
+polyfit_error_t polyfit_piecewise_evaluate(const polyfit_piecewise_t* pw,
+                                           float x, float* result) {
+  if (pw == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  *result = piecewise_horner(pw, piecewise_locate(pw, x), x);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_piecewise_evaluate_batch(const polyfit_piecewise_t* pw,
+                                                 const float* xs, float* out,
+                                                 int32_t num_points) {
+  if (pw == NULL || xs == NULL || out == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (num_points < 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  for (int32_t i = 0; i < num_points; i++) {
+    out[i] = piecewise_horner(pw, piecewise_locate(pw, xs[i]), xs[i]);
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_piecewise_evaluate_sorted(
+    const polyfit_piecewise_t* pw, const float* xs, float* out,
+    int32_t num_points) {
+  if (pw == NULL || xs == NULL || out == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (num_points < 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (num_points == 0) {
+    return POLYFIT_SUCCESS;
+  }
+
+  const float* knots = pw->breakpoints;
+  const int32_t last = pw->num_segments - 1;
+  int32_t segment = piecewise_locate(pw, xs[0]);
+
+  for (int32_t i = 0; i < num_points; i++) {
+    const float x = xs[i];
+    if (segment > 0 && x < knots[segment]) {
+      segment = piecewise_locate(pw, x);
+    }
+    while (segment < last && x >= knots[segment + 1]) {
+      segment++;
+    }
+    out[i] = piecewise_horner(pw, segment, x);
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* FIT PLAN IMPLEMENTATIONS                                                  */
+/*============================================================================*/
+
+polyfit_plan_t* polyfit_plan_create(const float* x, int32_t num_points,
+                                    int32_t degree, polyfit_error_t* error) {
+  polyfit_error_t local_error = POLYFIT_SUCCESS;
+  polyfit_plan_t* plan = NULL;
+  const int32_t size = degree + 1;
+
+  if (x == NULL) {
+    local_error = POLYFIT_ERROR_NULL_POINTER;
+  } else if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    local_error = POLYFIT_ERROR_INVALID_DEGREE;
+  } else if (num_points <= degree) {
+    local_error = POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  // Map [x_min, x_max] onto [-1, 1] and check the grid in the same pass
+  float x_min = 0.0f;
+  float x_max = 0.0f;
+  if (local_error == POLYFIT_SUCCESS) {
+    x_min = x[0];
+    x_max = x[0];
+    for (int32_t i = 0; i < num_points; i++) {
+      if (x[i] - x[i] != 0.0f) {  // NaN and Inf check
+        local_error = POLYFIT_ERROR_INVALID_INPUT;
+        break;
+      }
+      x_min = (x[i] < x_min) ? x[i] : x_min;
+      x_max = (x[i] > x_max) ? x[i] : x_max;
+    }
+  }
+  const float half_range = 0.5f * x_max - 0.5f * x_min;
+  const float x_offset = 0.5f * x_min + 0.5f * x_max;
+  const float x_scale = (half_range > 0.0f) ? 1.0f / half_range : 1.0f;
+
+  // Thin QR of V = Q R, with V[k][j] = t_k^j; Q is column-major
+  double* q = NULL;
+  double r[POLYFIT_MAX_DEGREE + 1][POLYFIT_MAX_DEGREE + 1];
+  if (local_error == POLYFIT_SUCCESS) {
+    q = (double*)polyfit_alloc((size_t)size * num_points * sizeof(double));
+    if (q == NULL) {
+      local_error = POLYFIT_ERROR_MEMORY_ALLOC;
+    }
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    local_error = plan_factor(x, num_points, size, (double)x_offset,
+                              (double)x_scale, q, r);
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    plan = (polyfit_plan_t*)polyfit_alloc(sizeof(polyfit_plan_t));
+    if (plan != NULL) {
+      plan->projection =
+          (float*)polyfit_alloc((size_t)size * num_points * sizeof(float));
+      if (plan->projection == NULL) {
+        polyfit_dealloc(plan);
+        plan = NULL;
+      }
+    }
+    if (plan == NULL) {
+      local_error = POLYFIT_ERROR_MEMORY_ALLOC;
+    }
+  }
+
+  if (local_error != POLYFIT_SUCCESS) {
+    polyfit_dealloc(q);
+    if (error != NULL) {
+      *error = local_error;
+    }
+    return NULL;
+  }
+
+  // P = R^-1 Q^T, one grid point (one column of P) at a time by back
+  // substitution against that point's row of Q
+  for (int32_t k = 0; k < num_points; k++) {
+    double column[POLYFIT_MAX_DEGREE + 1];
+    for (int32_t i = size - 1; i >= 0; i--) {
+      double sum = q[(size_t)i * num_points + k];
+      for (int32_t j = i + 1; j < size; j++) {
+        sum -= r[i][j] * column[j];
+      }
+      column[i] = sum / r[i][i];
+      plan->projection[(size_t)i * num_points + k] = (float)column[i];
+    }
+  }
+  polyfit_dealloc(q);
+
+  plan->num_points = num_points;
+  plan->degree = degree;
+  plan->x_offset = x_offset;
+  plan->x_scale = x_scale;
+
+  if (error != NULL) {
+    *error = POLYFIT_SUCCESS;
+  }
+
+  return plan;
+}
+
+void polyfit_plan_free(polyfit_plan_t* plan) {
+  if (plan != NULL) {
+    polyfit_dealloc(plan->projection);
+    plan->projection = NULL;
+    polyfit_dealloc(plan);
+  }
+}
+
+polyfit_error_t polyfit_plan_execute(const polyfit_plan_t* plan,
+                                     const float* y, Polynomial* result_poly) {
+  if (plan == NULL || y == NULL || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  float coeffs[POLYFIT_MAX_DEGREE + 1];
+  plan_project(plan, y, 1, coeffs);
+
+  // A NaN or infinite y propagates into every coefficient
+  for (int32_t i = 0; i <= plan->degree; i++) {
+    if (!isfinite(coeffs[i])) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+  }
+
+  for (int32_t i = 0; i <= plan->degree; i++) {
+    result_poly->coefficients[i] = coeffs[i];
+  }
+  result_poly->degree = plan->degree;
+  result_poly->is_valid = true;
+  set_domain(result_poly, true, plan->x_offset, plan->x_scale);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_plan_execute_batch(const polyfit_plan_t* plan,
+                                           const float* ys, int32_t num_series,
+                                           float* coeffs) {
+  if (plan == NULL || ys == NULL || coeffs == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (num_series <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  plan_project(plan, ys, num_series, coeffs);
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* ORTHOGONAL POLYNOMIAL IMPLEMENTATIONS                                     */
+/*============================================================================*/
+
+polyfit_error_t polyfit_orthogonal_fit(const float* x, const float* y,
+                                       int32_t num_points, int32_t degree,
+                                       polyfit_orthogonal_t* result) {
+  if (x == NULL || y == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= degree) {
+    return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  // Map [x_min, x_max] onto [-1, 1] and check the inputs in the same pass
+  float x_min = x[0];
+  float x_max = x[0];
+  for (int32_t i = 0; i < num_points; i++) {
+    if (x[i] - x[i] != 0.0f || y[i] - y[i] != 0.0f) {  // NaN and Inf check
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+    if (x[i] < x_min) {
+      x_min = x[i];
+    }
+    if (x[i] > x_max) {
+      x_max = x[i];
+    }
+  }
+
+  const float half_range = 0.5f * x_max - 0.5f * x_min;
+  result->x_offset = 0.5f * x_min + 0.5f * x_max;
+  result->x_scale = (half_range > 0.0f) ? 1.0f / half_range : 1.0f;
+
+  // p_prev, p_cur hold p_{k-1} and p_k at every point; r is the residual
+  float* p_prev = (float*)polyfit_alloc((size_t)num_points * sizeof(float));
+  float* p_cur = (float*)polyfit_alloc((size_t)num_points * sizeof(float));
+  float* r = (float*)polyfit_alloc((size_t)num_points * sizeof(float));
+  if (p_prev == NULL || p_cur == NULL || r == NULL) {
+    polyfit_dealloc(p_prev);
+    polyfit_dealloc(p_cur);
+    polyfit_dealloc(r);
+    return POLYFIT_ERROR_MEMORY_ALLOC;
+  }
+
+  double rss = 0.0;
+  for (int32_t i = 0; i < num_points; i++) {
+    p_prev[i] = 0.0f;
+    p_cur[i] = 1.0f;
+    r[i] = y[i];
+    rss += (double)y[i] * (double)y[i];
+  }
+
+  polyfit_error_t error = POLYFIT_SUCCESS;
+  double prev_norm = 1.0;
+
+  for (int32_t k = 0; k <= degree; k++) {
+    // Pass 1: |p_k|^2, <r, p_k> and <t p_k, p_k>
+    double norm = 0.0;
+    double proj = 0.0;
+    double moment = 0.0;
+    for (int32_t i = 0; i < num_points; i++) {
+      const double t = (double)((x[i] - result->x_offset) * result->x_scale);
+      const double p = (double)p_cur[i];
+      norm += p * p;
+      proj += (double)r[i] * p;
+      moment += t * p * p;
+    }
+
+    if (norm < 1e-30) {
+      // Fewer distinct x values than coefficients
+      error = POLYFIT_ERROR_SINGULAR_MATRIX;
+      break;
+    }
+
+    // Projecting the running residual (rather than y) keeps the
+    // coefficients accurate when the basis is only nearly orthogonal
+    const double b = proj / norm;
+    const double alpha = moment / norm;
+    const double beta = (k > 0) ? norm / prev_norm : 0.0;
+    result->coefficients[k] = (float)b;
+    result->alpha[k] = (float)alpha;
+    result->beta[k] = (float)beta;
+
+    rss -= b * b * norm;
+    result->rss[k] = (rss > 0.0) ? (float)rss : 0.0f;
+
+    // Pass 2: remove this component from r and step the recurrence
+    for (int32_t i = 0; i < num_points; i++) {
+      const float t = (x[i] - result->x_offset) * result->x_scale;
+      const float p = p_cur[i];
+      r[i] -= (float)b * p;
+      p_cur[i] = (t - (float)alpha) * p - (float)beta * p_prev[i];
+      p_prev[i] = p;
+    }
+    prev_norm = norm;
+  }
+
+  polyfit_dealloc(p_prev);
+  polyfit_dealloc(p_cur);
+  polyfit_dealloc(r);
+
+  if (error == POLYFIT_SUCCESS) {
+    result->degree = degree;
+  }
+
+  return error;
+}
+
+polyfit_error_t polyfit_orthogonal_evaluate(const polyfit_orthogonal_t* ortho,
+                                            float x, float* result) {
+  if (ortho == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const float t = (x - ortho->x_offset) * ortho->x_scale;
+  float u1 = 0.0f;  // u_{k+1}
+  float u2 = 0.0f;  // u_{k+2}
+
+  // Clenshaw: u_k = c_k + (t - alpha_k) u_{k+1} - beta_{k+1} u_{k+2}
+  for (int32_t k = ortho->degree; k >= 0; k--) {
+    const float beta_next = (k < ortho->degree) ? ortho->beta[k + 1] : 0.0f;
+    const float u0 =
+        ortho->coefficients[k] + (t - ortho->alpha[k]) * u1 - beta_next * u2;
+    u2 = u1;
+    u1 = u0;
+  }
+
+  *result = u1;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_orthogonal_to_polynomial(
+    const polyfit_orthogonal_t* ortho, int32_t degree, Polynomial* result_poly) {
+  if (ortho == NULL || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > ortho->degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  // Monomial coefficients of p_{k-1} and p_k in t, built by the recurrence
+  double prev[POLYFIT_MAX_DEGREE + 2] = {0.0};
+  double cur[POLYFIT_MAX_DEGREE + 2] = {0.0};
+  double sum[POLYFIT_MAX_DEGREE + 1] = {0.0};
+  cur[0] = 1.0;
+
+  for (int32_t k = 0; k <= degree; k++) {
+    for (int32_t j = 0; j <= k; j++) {
+      sum[j] += (double)ortho->coefficients[k] * cur[j];
+    }
+
+    if (k < degree) {
+      double next[POLYFIT_MAX_DEGREE + 2] = {0.0};
+      for (int32_t j = 0; j <= k; j++) {
+        next[j + 1] += cur[j];
+        next[j] -= (double)ortho->alpha[k] * cur[j];
+        next[j] -= (double)ortho->beta[k] * prev[j];
+      }
+      for (int32_t j = 0; j <= k + 1; j++) {
+        prev[j] = cur[j];
+        cur[j] = next[j];
+      }
+    }
+  }
+
+  for (int32_t j = 0; j <= degree; j++) {
+    result_poly->coefficients[j] = (float)sum[j];
+  }
+  result_poly->degree = degree;
+  result_poly->is_valid = true;
+  set_domain(result_poly, true, ortho->x_offset, ortho->x_scale);
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* WORKSPACE AND ALLOCATOR IMPLEMENTATIONS                                   */
+/*============================================================================*/
+
+polyfit_error_t polyfit_set_allocator(const polyfit_allocator_t* allocator) {
+  if (allocator == NULL) {
+    g_allocator.alloc = default_alloc;
+    g_allocator.free = default_free;
+    g_allocator.user_data = NULL;
+    return POLYFIT_SUCCESS;
+  }
+
+  if (allocator->alloc == NULL || allocator->free == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  g_allocator = *allocator;
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_workspace_t* polyfit_workspace_create(
+    int32_t max_degree, const polyfit_allocator_t* allocator) {
+  if (max_degree < 0 || max_degree > POLYFIT_MAX_DEGREE) {
+    return NULL;
+  }
+
+  if (allocator == NULL) {
+    allocator = &g_allocator;
+  }
+
+  if (allocator->alloc == NULL || allocator->free == NULL) {
+    return NULL;
+  }
+
+  // One block: the struct followed by its float buffer
+  const size_t buffer_len = (size_t)POLYFIT_WORKSPACE_FLOATS(max_degree);
+  polyfit_workspace_t* ws = (polyfit_workspace_t*)allocator->alloc(
+      sizeof(polyfit_workspace_t) + buffer_len * sizeof(float),
+      allocator->user_data);
+  if (ws == NULL) {
+    return NULL;
+  }
+  POLYFIT_STATS_COUNT(allocations, 1);
+
+  polyfit_workspace_init(ws, (float*)(ws + 1), (int32_t)buffer_len,
+                         max_degree);
+  ws->owns_memory = true;
+  ws->allocator = *allocator;
+
+  return ws;
+}
+
+polyfit_error_t polyfit_workspace_init(polyfit_workspace_t* ws, float* buffer,
+                                       int32_t buffer_len, int32_t max_degree) {
+  if (ws == NULL || buffer == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (max_degree < 0 || max_degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (buffer_len < POLYFIT_WORKSPACE_FLOATS(max_degree)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  ws->matrix = buffer;
+  ws->rhs = buffer + (max_degree + 1) * (max_degree + 1);
+  moments_reset(&ws->moments, max_degree);
+  ws->max_degree = max_degree;
+  ws->owns_memory = false;
+  ws->allocator = g_allocator;
+
+  return POLYFIT_SUCCESS;
+}
+
+void polyfit_workspace_free(polyfit_workspace_t* ws) {
+  if (ws != NULL && ws->owns_memory) {
+    ws->allocator.free(ws, ws->allocator.user_data);
+  }
+}
+
+polyfit_error_t polyfit_least_squares_ws(const float* x, const float* y,
+                                         int32_t num_points, int32_t degree,
+                                         const polyfit_config_t* config,
+                                         polyfit_workspace_t* ws,
+                                         Polynomial* result_poly) {
+  if (ws == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  return least_squares_impl(&x_in, &y_in, NULL, num_points, degree, config,
+                            ws, result_poly, NULL);
+}
+
+polyfit_error_t polyfit_least_squares_weighted_ws(
+    const float* x, const float* y, const float* w, int32_t num_points,
+    int32_t degree, const polyfit_config_t* config, polyfit_workspace_t* ws,
+    Polynomial* result_poly) {
+  if (w == NULL || ws == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t w_in = polyfit_input(w, POLYFIT_TYPE_FLOAT);
+  return least_squares_impl(&x_in, &y_in, &w_in, num_points, degree, config,
+                            ws, result_poly, NULL);
+}
+
+polyfit_error_t polyfit_least_squares_typed_ws(const polyfit_input_t* x,
+                                               const polyfit_input_t* y,
+                                               int32_t num_points,
+                                               int32_t degree,
+                                               const polyfit_config_t* config,
+                                               polyfit_workspace_t* ws,
+                                               Polynomial* result_poly) {
+  if (ws == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  return least_squares_impl(x, y, NULL, num_points, degree, config, ws,
+                            result_poly, NULL);
+}
+
+polyfit_error_t polyfit_least_squares_quality_ws(
+    const float* x, const float* y, int32_t num_points, int32_t degree,
+    const polyfit_config_t* config, polyfit_workspace_t* ws,
+    Polynomial* result_poly, polyfit_quality_t* quality) {
+  if (ws == NULL || quality == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  return least_squares_impl(&x_in, &y_in, NULL, num_points, degree, config,
+                            ws, result_poly, quality);
+}
+
+polyfit_error_t polyfit_fit_moments_ws(const polyfit_moments_t* moments,
+                                       int32_t degree, polyfit_workspace_t* ws,
+                                       Polynomial* result_poly) {
+  if (moments == NULL || ws == NULL || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > moments->degree || degree > ws->max_degree) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (moments->num_points <= degree) {
+    return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  return solve_moments(moments, degree, ws->matrix, ws->rhs, result_poly);
+}
+
+/*============================================================================*/
+/* STATIC POLYNOMIAL IMPLEMENTATIONS                                         */
+/*============================================================================*/
+
+polyfit_error_t polyfit_static_init(polyfit_static_poly_t* poly,
+                                    int32_t degree) {
+  if (poly == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  memset(poly->coefficients, 0, sizeof(poly->coefficients));
+  poly->degree = degree;
+  poly->is_valid = true;
+  poly->is_normalized = false;
+  poly->x_offset = 0.0f;
+  poly->x_scale = 1.0f;
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_static_fit(const float* x, const float* y,
+                                   int32_t num_points, int32_t degree,
+                                   const polyfit_config_t* config,
+                                   polyfit_static_poly_t* result_poly) {
+  if (result_poly == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  // Solve straight into the inline array, then copy the header fields back
+  Polynomial view = {0};
+  view.coefficients = result_poly->coefficients;
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  polyfit_error_t error = least_squares_impl(
+      &x_in, &y_in, NULL, num_points, degree, config, NULL, &view, NULL);
+  if (error == POLYFIT_SUCCESS) {
+    result_poly->degree = view.degree;
+    result_poly->is_valid = view.is_valid;
+    result_poly->is_normalized = view.is_normalized;
+    result_poly->x_offset = view.x_offset;
+    result_poly->x_scale = view.x_scale;
+  }
+
+  return error;
+}
+
+polyfit_error_t polyfit_static_evaluate(const polyfit_static_poly_t* poly,
+                                        float x, float* result) {
+  if (poly == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!poly->is_valid || poly->degree < 0 ||
+      poly->degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (poly->is_normalized) {
+    x = (x - poly->x_offset) * poly->x_scale;
+  }
+
+  *result = poly_eval(poly->coefficients, poly->degree, x);
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_static_evaluate_batch(
+    const polyfit_static_poly_t* poly, const float* xs, float* out,
+    int32_t num_points) {
+  if (poly == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const Polynomial view = polyfit_static_view((polyfit_static_poly_t*)poly);
+  return polyfit_evaluate_batch(&view, xs, out, num_points);
+}
+
+polyfit_error_t polyfit_static_get_coefficients(
+    const polyfit_static_poly_t* poly, float* coeffs, int32_t size) {
+  if (poly == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const Polynomial view = polyfit_static_view((polyfit_static_poly_t*)poly);
+  return polyfit_get_coefficients(&view, coeffs, size);
+}
+
+polyfit_error_t polyfit_static_from_polynomial(polyfit_static_poly_t* dst,
+                                               const Polynomial* src) {
+  if (dst == NULL || src == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(src)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  memset(dst->coefficients, 0, sizeof(dst->coefficients));
+  memcpy(dst->coefficients, src->coefficients,
+         (size_t)(src->degree + 1) * sizeof(float));
+  dst->degree = src->degree;
+  dst->is_valid = true;
+  dst->is_normalized = src->is_normalized;
+  dst->x_offset = src->x_offset;
+  dst->x_scale = src->x_scale;
+
+  return POLYFIT_SUCCESS;
+}
+
+Polynomial polyfit_static_view(polyfit_static_poly_t* poly) {
+  Polynomial view = {0};
+  if (poly != NULL) {
+    view.coefficients = poly->coefficients;
+    view.degree = poly->degree;
+    view.is_valid = poly->is_valid;
+    view.is_normalized = poly->is_normalized;
+    view.x_offset = poly->x_offset;
+    view.x_scale = poly->x_scale;
+  }
+  return view;
+}
+
+/*============================================================================*/
+/* FIXED-POINT IMPLEMENTATIONS                                               */
+/*============================================================================*/
+
+polyfit_error_t polyfit_fixed_from_polynomial(const Polynomial* poly,
+                                              float x_min, float x_max,
+                                              int32_t input_frac_bits,
+                                              polyfit_fixed_t* fixed) {
+  if (poly == NULL || fixed == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  float max_magnitude;
+  polyfit_get_max_coefficient_magnitude(poly, &max_magnitude);
+  if (!isfinite(max_magnitude) || !isfinite(x_min) || !isfinite(x_max) ||
+      !(x_max > x_min) || input_frac_bits < 0 || input_frac_bits > 30) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  // The input range in Q input_frac_bits must itself fit an int32
+  const double in_unit = ldexp(1.0, input_frac_bits);
+  const double lo_q = floor((double)x_min * in_unit);
+  const double hi_q = ceil((double)x_max * in_unit);
+  if (lo_q < (double)INT32_MIN || hi_q > (double)INT32_MAX) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  memset(fixed, 0, sizeof(*fixed));
+  fixed->degree = poly->degree;
+  fixed->input_frac_bits = input_frac_bits;
+  fixed->x_min = (int32_t)lo_q;
+  fixed->x_max = (int32_t)hi_q;
+  fixed->is_normalized = poly->is_normalized;
+
+  // Largest |t| over the range, and the error made forming t from x
+  const double lo = lo_q / in_unit;
+  const double hi = hi_q / in_unit;
+  double t_max;
+  double t_error = 0.0;
+  if (poly->is_normalized) {
+    const double offset_q = nearbyint((double)poly->x_offset * in_unit);
+    const double scale = fabs((double)poly->x_scale);
+    const double span =
+        fmax(fabs(lo - offset_q / in_unit), fabs(hi - offset_q / in_unit));
+    t_max = span * scale;
+    fixed->t_frac_bits = fixed_frac_bits(t_max);
+
+    // The scale keeps 30 bits, less if (x - offset) * scale would pass 2^61
+    int32_t scale_bits = fixed_frac_bits(scale);
+    const int32_t product_limit = 31 + fixed->t_frac_bits - input_frac_bits;
+    scale_bits = (scale_bits < product_limit) ? scale_bits : product_limit;
+
+    fixed->x_offset = (int64_t)offset_q;
+    fixed->scale_frac_bits = scale_bits;
+    fixed->x_scale =
+        (int32_t)nearbyint(ldexp((double)poly->x_scale, scale_bits));
+    fixed->t_shift = input_frac_bits + scale_bits - fixed->t_frac_bits;
+
+    // Actual rounding of the stored offset and scale, not the half-unit
+    // worst case, so exactly representable domains cost nothing
+    const double offset_error =
+        fabs((double)poly->x_offset - offset_q / in_unit);
+    const double scale_error = fabs(
+        (double)poly->x_scale - ldexp((double)fixed->x_scale, -scale_bits));
+    t_error = scale * offset_error + span * scale_error;
+  } else {
+    t_max = fmax(fabs(lo), fabs(hi));
+    fixed->t_frac_bits = fixed_frac_bits(t_max);
+    fixed->t_shift = input_frac_bits - fixed->t_frac_bits;
+  }
+  if (fixed->t_shift > 0) {
+    t_error += ldexp(0.5, -fixed->t_frac_bits);
+  }
+
+  // Bound every Horner partial sum h_k = c_k + t * h_{k+1} over the range
+  const int32_t degree = poly->degree;
+  const double t_bound = t_max + t_error;
+  double bound[POLYFIT_MAX_DEGREE + 1];
+  bound[degree] = fabs((double)poly->coefficients[degree]);
+  for (int32_t k = degree - 1; k >= 0; k--) {
+    bound[k] = fabs((double)poly->coefficients[k]) + t_bound * bound[k + 1];
+  }
+
+  for (int32_t k = 0; k <= degree; k++) {
+    const int32_t bits = fixed_frac_bits(bound[k]);
+    if (bits < -30) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+    fixed->frac_bits[k] = bits;
+    fixed->coefficients[k] =
+        (int32_t)nearbyint(ldexp((double)poly->coefficients[k], bits));
+  }
+  for (int32_t k = 0; k < degree; k++) {
+    fixed->shifts[k] =
+        fixed->frac_bits[k + 1] + fixed->t_frac_bits - fixed->frac_bits[k];
+  }
+
+  // Propagate coefficient rounding, the error in t and each step's rounding
+  double error = ldexp(0.5, -fixed->frac_bits[degree]);
+  for (int32_t k = degree - 1; k >= 0; k--) {
+    const double step_rounding =
+        (fixed->shifts[k] > 0) ? ldexp(0.5, -fixed->frac_bits[k]) : 0.0;
+    error = error * t_bound + bound[k + 1] * t_error + step_rounding +
+            ldexp(0.5, -fixed->frac_bits[k]);
+  }
+  fixed->error_bound = (float)error;
+
+  return POLYFIT_SUCCESS;
+}
+
+int32_t polyfit_fixed_evaluate(const polyfit_fixed_t* fixed, int32_t x) {
+  x = (x < fixed->x_min) ? fixed->x_min : x;
+  x = (x > fixed->x_max) ? fixed->x_max : x;
+
+  int32_t t;
+  if (fixed->is_normalized) {
+    const int64_t diff = (int64_t)x - fixed->x_offset;
+    t = (int32_t)fixed_shift(diff * fixed->x_scale, fixed->t_shift);
+  } else {
+    t = (int32_t)fixed_shift((int64_t)x, fixed->t_shift);
+  }
+
+  // Horner's method: 32-bit partial sums, 64-bit products
+  int32_t acc = fixed->coefficients[fixed->degree];
+  for (int32_t k = fixed->degree - 1; k >= 0; k--) {
+    acc = (int32_t)(fixed_shift((int64_t)acc * t, fixed->shifts[k]) +
+                    fixed->coefficients[k]);
+  }
+
+  return acc;
+}
+
+polyfit_error_t polyfit_fixed_evaluate_batch(const polyfit_fixed_t* fixed,
+                                             const int32_t* xs, int32_t* out,
+                                             int32_t num_points) {
+  if (fixed == NULL || xs == NULL || out == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (num_points < 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  for (int32_t i = 0; i < num_points; i++) {
+    out[i] = polyfit_fixed_evaluate(fixed, xs[i]);
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* INVERSE EVALUATION IMPLEMENTATIONS                                        */
+/*============================================================================*/
+
+polyfit_error_t polyfit_inverse(const Polynomial* poly, float y, float lo,
+                                float hi, float* x) {
+  if (poly == NULL || x == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  float solutions[1];
+  polyfit_error_t error = polyfit_inverse_batch(poly, &y, solutions, 1, lo, hi);
+  if (error == POLYFIT_SUCCESS) {
+    *x = solutions[0];
+  }
+
+  return error;
+}
+
+polyfit_error_t polyfit_inverse_batch(const Polynomial* poly, const float* ys,
+                                      float* xs, int32_t num_points, float lo,
+                                      float hi) {
+  if (poly == NULL || ys == NULL || xs == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly) || num_points < 0 || !isfinite(lo) ||
+      !isfinite(hi) || !(hi > lo)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  // The end values are shared by every target, so each bracket check is a
+  // comparison
+  double p_lo;
+  double p_hi;
+  double slope;
+  eval_with_derivative(poly, (double)lo, &p_lo, &slope);
+  eval_with_derivative(poly, (double)hi, &p_hi, &slope);
+
+  polyfit_error_t error = POLYFIT_SUCCESS;
+  double guess = 0.5 * ((double)lo + (double)hi);
+  for (int32_t i = 0; i < num_points; i++) {
+    const double y = (double)ys[i];
+    const double f_lo = p_lo - y;
+    const double f_hi = p_hi - y;
+    if (!(f_lo * f_hi <= 0.0)) {
+      xs[i] = NAN;
+      error = POLYFIT_ERROR_INVALID_INPUT;
+      continue;
+    }
+
+    // Warm start: sorted targets have neighbouring solutions
+    guess = inverse_solve(poly, y, (double)lo, (double)hi, f_lo, guess);
+    xs[i] = (float)guess;
+  }
+
+  return error;
+}
+
+Polynomial* polyfit_inverse_polynomial(const Polynomial* poly, float lo,
+                                       float hi, int32_t degree,
+                                       float* max_error,
+                                       polyfit_error_t* error) {
+  polyfit_error_t local_error = POLYFIT_SUCCESS;
+  Polynomial* inverse = NULL;
+
+  if (poly == NULL) {
+    local_error = POLYFIT_ERROR_NULL_POINTER;
+  } else if (degree < 1 || degree > POLYFIT_MAX_DEGREE) {
+    local_error = POLYFIT_ERROR_INVALID_DEGREE;
+  } else if (!polyfit_is_valid(poly) || !isfinite(lo) || !isfinite(hi) ||
+             !(hi > lo)) {
+    local_error = POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  float xs[POLYFIT_INVERSE_SAMPLES];
+  float ys[POLYFIT_INVERSE_SAMPLES];
+  if (local_error == POLYFIT_SUCCESS) {
+    const float step = (hi - lo) / (float)(POLYFIT_INVERSE_SAMPLES - 1);
+    for (int32_t i = 0; i < POLYFIT_INVERSE_SAMPLES; i++) {
+      xs[i] = (i == POLYFIT_INVERSE_SAMPLES - 1) ? hi : lo + step * (float)i;
+    }
+    horner_batch(poly, xs, ys, POLYFIT_INVERSE_SAMPLES);
+
+    // x must be a function of y: the samples have to be strictly monotonic
+    const bool rising = ys[1] > ys[0];
+    for (int32_t i = 1; i < POLYFIT_INVERSE_SAMPLES; i++) {
+      if (rising ? !(ys[i] > ys[i - 1]) : !(ys[i] < ys[i - 1])) {
+        local_error = POLYFIT_ERROR_INVALID_INPUT;
+        break;
+      }
+    }
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    inverse = polyfit_init(degree);
+    if (inverse == NULL) {
+      local_error = POLYFIT_ERROR_MEMORY_ALLOC;
+    }
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    local_error = polyfit_least_squares_ex(ys, xs, POLYFIT_INVERSE_SAMPLES,
+                                           degree, &config, inverse);
+  }
+
+  if (local_error == POLYFIT_SUCCESS && max_error != NULL) {
+    float fitted[POLYFIT_INVERSE_SAMPLES];
+    horner_batch(inverse, ys, fitted, POLYFIT_INVERSE_SAMPLES);
+    float worst = 0.0f;
+    for (int32_t i = 0; i < POLYFIT_INVERSE_SAMPLES; i++) {
+      const float deviation = polyfit_fabs(fitted[i] - xs[i]);
+      worst = (deviation > worst) ? deviation : worst;
+    }
+    *max_error = worst;
+  }
+
+  if (local_error != POLYFIT_SUCCESS) {
+    polyfit_free(inverse);
+    inverse = NULL;
+  }
+
+  if (error != NULL) {
+    *error = local_error;
+  }
+
+  return inverse;
+}
+
+/*============================================================================*/
+/* CALCULUS IMPLEMENTATIONS                                                  */
+/*============================================================================*/
+
+Polynomial* polyfit_derivative(const Polynomial* poly, polyfit_error_t* error) {
+  polyfit_error_t local_error = POLYFIT_SUCCESS;
+  Polynomial* derivative = NULL;
+
+  if (poly == NULL) {
+    local_error = POLYFIT_ERROR_NULL_POINTER;
+  } else if (!polyfit_is_valid(poly)) {
+    local_error = POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    derivative = polyfit_init((poly->degree > 0) ? poly->degree - 1 : 0);
+    if (derivative == NULL) {
+      local_error = POLYFIT_ERROR_MEMORY_ALLOC;
+    }
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    // dp/dx = x_scale * dp/dt on a normalized domain
+    const float scale = poly->is_normalized ? poly->x_scale : 1.0f;
+    for (int32_t k = 1; k <= poly->degree; k++) {
+      derivative->coefficients[k - 1] =
+          (float)k * scale * poly->coefficients[k];
+    }
+    set_domain(derivative, poly->is_normalized, poly->x_offset, poly->x_scale);
+  }
+
+  if (error != NULL) {
+    *error = local_error;
+  }
+
+  return derivative;
+}
+
+Polynomial* polyfit_antiderivative(const Polynomial* poly,
+                                   polyfit_error_t* error) {
+  polyfit_error_t local_error = POLYFIT_SUCCESS;
+  Polynomial* antiderivative = NULL;
+
+  if (poly == NULL) {
+    local_error = POLYFIT_ERROR_NULL_POINTER;
+  } else if (!polyfit_is_valid(poly)) {
+    local_error = POLYFIT_ERROR_INVALID_INPUT;
+  } else if (poly->degree >= POLYFIT_MAX_DEGREE) {
+    local_error = POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    antiderivative = polyfit_init(poly->degree + 1);
+    if (antiderivative == NULL) {
+      local_error = POLYFIT_ERROR_MEMORY_ALLOC;
+    }
+  }
+
+  if (local_error == POLYFIT_SUCCESS) {
+    // Integrating in t divides by x_scale, since dx = dt / x_scale
+    const double scale = poly->is_normalized ? (double)poly->x_scale : 1.0;
+    for (int32_t k = 0; k <= poly->degree; k++) {
+      antiderivative->coefficients[k + 1] =
+          (float)((double)poly->coefficients[k] / ((double)(k + 1) * scale));
+    }
+    set_domain(antiderivative, poly->is_normalized, poly->x_offset,
+               poly->x_scale);
+  }
+
+  if (error != NULL) {
+    *error = local_error;
+  }
+
+  return antiderivative;
+}
+
+polyfit_error_t polyfit_evaluate_derivatives(const Polynomial* poly, float x,
+                                             float* value, float* first,
+                                             float* second) {
+  return polyfit_evaluate_derivatives_batch(poly, &x, value, first, second, 1);
+}
+
+polyfit_error_t polyfit_evaluate_derivatives_batch(const Polynomial* poly,
+                                                   const float* xs,
+                                                   float* values, float* firsts,
+                                                   float* seconds,
+                                                   int32_t num_points) {
+  if (poly == NULL || xs == NULL || values == NULL || firsts == NULL ||
+      seconds == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly) || num_points < 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  const bool normalized = poly->is_normalized;
+  const float offset = poly->x_offset;
+  const float scale = normalized ? poly->x_scale : 1.0f;
+  const float scale2 = scale * scale;
+  for (int32_t i = 0; i < num_points; i++) {
+    const float t = normalized ? (xs[i] - offset) * scale : xs[i];
+    float first;
+    float second;
+    horner_derivatives(poly->coefficients, poly->degree, t, &values[i], &first,
+                       &second);
+    firsts[i] = first * scale;
+    seconds[i] = second * scale2;
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+polyfit_error_t polyfit_integrate(const Polynomial* poly, float a, float b,
+                                  float* result) {
+  if (poly == NULL || result == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!polyfit_is_valid(poly) || !isfinite(a) || !isfinite(b)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  *result = (float)(antiderivative_eval(poly, (double)b) -
+                    antiderivative_eval(poly, (double)a));
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* INSTRUMENTATION IMPLEMENTATIONS                                           */
+/*============================================================================*/
+
+polyfit_error_t polyfit_stats_get(polyfit_stats_t* stats) {
+  if (stats == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+#if defined(POLYFIT_ENABLE_STATS)
+  *stats = t_stats;
+  stats->enabled = true;
+#else
+  memset(stats, 0, sizeof(*stats));
+#endif
+
+  return POLYFIT_SUCCESS;
+}
+
+void polyfit_stats_reset(void) {
+#if defined(POLYFIT_ENABLE_STATS)
+  memset(&t_stats, 0, sizeof(t_stats));
+  t_pending_accumulate_ns = 0;
+#endif
+}
+
+polyfit_error_t polyfit_set_stats_callback(polyfit_stats_callback_t callback,
+                                           void* user_data) {
+#if defined(POLYFIT_ENABLE_STATS)
+  g_stats_callback = callback;
+  g_stats_user_data = (callback != NULL) ? user_data : NULL;
+#else
+  (void)callback;
+  (void)user_data;
+#endif
+
+  return POLYFIT_SUCCESS;
+}
+
+/*============================================================================*/
+/* UTILITY FUNCTION IMPLEMENTATIONS                                          */
+/*============================================================================*/
+
+float polyfit_pow(float base, int32_t exponent) {
+  // Handle special cases
+  if (exponent == 0) {
+    return 1.0f;
+  }
+
+  if (base == 0.0f) {
+    return (exponent > 0) ? 0.0f : 1.0f;  // 0^0 = 1 by convention
+  }
+
+  if (base == 1.0f) {
+    return 1.0f;
+  }
+
+  if (base == -1.0f) {
+    return (exponent % 2 == 0) ? 1.0f : -1.0f;
+  }
+
+  // Use binary exponentiation
+  float result = 1.0f;
+  float current_base = base;
+  int32_t abs_exponent = (exponent < 0) ? -exponent : exponent;
+
+  while (abs_exponent > 0) {
+    if (abs_exponent & 1) {
+      result *= current_base;
+    }
+    current_base *= current_base;
+    abs_exponent >>= 1;
+  }
+
+  return (exponent < 0) ? (1.0f / result) : result;
+}
+
+float polyfit_fabs(float x) {
+  // Handle NaN
+  if (x != x) {
+    return x;
+  }
+
+  // Use bit manipulation for efficiency
+  union {
+    float f;
+    uint32_t i;
+  } u;
+
+  u.f = x;
+  u.i &= 0x7FFFFFFF;  // Clear sign bit
+
+  return u.f;
+}
+
+bool polyfit_is_nearly_zero(float value, float threshold) {
+  return polyfit_fabs(value) < threshold;
+}
+
+/*============================================================================*/
+/* PRIVATE FUNCTION IMPLEMENTATIONS                                          */
+/*============================================================================*/
+
+static polyfit_error_t gaussian_elimination(float* A, float* B, float* x,
+                                            int32_t n) {
+  if (A == NULL || B == NULL || x == NULL || n <= 0) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  const float pivot_threshold = 1e-12f;
+#if defined(POLYFIT_ENABLE_STATS)
+  float min_pivot = FLT_MAX;
+  float max_pivot = 0.0f;
+#endif
+
+  // Forward elimination with partial pivoting; A is n x n, row-major
+  for (int32_t i = 0; i < n; i++) {
+    float* row_i = A + (size_t)i * n;
+
+    // Find pivot
+    int32_t max_row = i;
+    for (int32_t k = i + 1; k < n; k++) {
+      if (polyfit_fabs(A[k * n + i]) > polyfit_fabs(A[max_row * n + i])) {
+        max_row = k;
+      }
+    }
+
+#if defined(POLYFIT_ENABLE_STATS)
+    // The spread of pivot magnitudes is a cheap conditioning estimate
+    const float pivot = polyfit_fabs(A[max_row * n + i]);
+    min_pivot = (pivot < min_pivot) ? pivot : min_pivot;
+    max_pivot = (pivot > max_pivot) ? pivot : max_pivot;
+    t_stats.last_pivot_ratio =
+        (max_pivot > 0.0f) ? min_pivot / max_pivot : 0.0f;
+#endif
+
+    // Check for singular matrix
+    if (polyfit_fabs(A[max_row * n + i]) < pivot_threshold) {
+      return POLYFIT_ERROR_SINGULAR_MATRIX;
+    }
+
+    // Swap rows; columns left of i are already zero and need not move
+    if (max_row != i) {
+      float* row_max = A + (size_t)max_row * n;
+      for (int32_t j = i; j < n; j++) {
+        float temp = row_i[j];
+        row_i[j] = row_max[j];
+        row_max[j] = temp;
+      }
+
+      float temp_b = B[i];
+      B[i] = B[max_row];
+      B[max_row] = temp_b;
+    }
+
+    // Eliminate column
+    for (int32_t k = i + 1; k < n; k++) {
+      float* row_k = A + (size_t)k * n;
+      float factor = row_k[i] / row_i[i];
+      for (int32_t j = i; j < n; j++) {
+        row_k[j] -= factor * row_i[j];
+      }
+      B[k] -= factor * B[i];
+    }
+  }
+
+  // Back substitution
+  for (int32_t i = n - 1; i >= 0; i--) {
+    x[i] = B[i];
+    for (int32_t j = i + 1; j < n; j++) {
+      x[i] -= A[i * n + j] * x[j];
+    }
+    x[i] /= A[i * n + i];
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+static polyfit_error_t solve_moments(const polyfit_moments_t* moments,
+                                     int32_t degree, float* A, float* B,
+                                     Polynomial* result_poly) {
+  const int32_t size = degree + 1;
+
+  POLYFIT_STATS_TIMESTAMP(build_start);
+  // Build normal equations (A^T * A * coeffs = A^T * y) from the moments;
+  // the matrix is Hankel, so each anti-diagonal holds a single power sum
+  for (int32_t i = 0; i < size; i++) {
+    for (int32_t j = 0; j < size; j++) {
+      A[i * size + j] = (float)moments->power_sums[i + j];
+    }
+    B[i] = (float)moments->cross_sums[i];
+  }
+
+  // Solve the system
+  POLYFIT_STATS_TIMESTAMP(solve_start);
+  polyfit_error_t error =
+      gaussian_elimination(A, B, result_poly->coefficients, size);
+  POLYFIT_STATS_SOLVE(moments, degree, error, build_start, solve_start);
+
+  if (error == POLYFIT_SUCCESS) {
+    result_poly->degree = degree;
+    result_poly->is_valid = true;
+    set_domain(result_poly, false, 0.0f, 1.0f);
+  }
+
+  return error;
+}
+
+static polyfit_error_t least_squares_impl(const polyfit_input_t* x,
+                                          const polyfit_input_t* y,
+                                          const polyfit_input_t* w,
+                                          int32_t num_points, int32_t degree,
+                                          const polyfit_config_t* config,
+                                          polyfit_workspace_t* ws,
+                                          Polynomial* result_poly,
+                                          polyfit_quality_t* quality) {
+  const polyfit_config_t defaults = polyfit_default_config();
+  if (config == NULL) {
+    config = &defaults;
+  }
+
+  if (x == NULL || y == NULL || !input_has_data(x) || !input_has_data(y) ||
+      (w != NULL && !input_has_data(w)) || result_poly == NULL ||
+      result_poly->coefficients == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (!input_valid(x) || !input_valid(y) || (w != NULL && !input_valid(w))) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE ||
+      (ws != NULL && degree > ws->max_degree)) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= degree) {
+    return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  float x_offset = 0.0f;
+  float x_scale = 1.0f;
+
+  if (config->normalize_domain) {
+    // Map [x_min, x_max] onto [-1, 1]
+    double block[POLYFIT_BLOCK_SIZE];
+    double lo = 0.0;
+    double hi = 0.0;
+    for (int32_t base = 0; base < num_points; base += POLYFIT_BLOCK_SIZE) {
+      int32_t count = num_points - base;
+      if (count > POLYFIT_BLOCK_SIZE) {
+        count = POLYFIT_BLOCK_SIZE;
+      }
+      load_input(x, base, count, block);
+      if (base == 0) {
+        lo = block[0];
+        hi = block[0];
+      }
+      for (int32_t i = 0; i < count; i++) {
+        if (block[i] < lo) {
+          lo = block[i];
+        }
+        if (block[i] > hi) {
+          hi = block[i];
+        }
+      }
+    }
+
+    const float x_min = (float)lo;
+    const float x_max = (float)hi;
+    const float half_range = 0.5f * x_max - 0.5f * x_min;
+    x_offset = 0.5f * x_min + 0.5f * x_max;
+    x_scale = (half_range > 0.0f) ? 1.0f / half_range : 1.0f;
+  }
+
+  // Without a workspace the moments and the system live on the stack
+  polyfit_moments_t local_moments;
+  float local_A[(POLYFIT_MAX_DEGREE + 1) * (POLYFIT_MAX_DEGREE + 1)];
+  float local_B[POLYFIT_MAX_DEGREE + 1];
+  polyfit_moments_t* moments = (ws != NULL) ? &ws->moments : &local_moments;
+
+  moments_reset(moments, degree);
+  polyfit_error_t error;
+  if (config->num_threads > 0) {
+    error = accumulate_moments_parallel(moments, x, y, w, num_points,
+                                        (double)x_offset, (double)x_scale,
+                                        config->num_threads, config->allocator);
+    if (error != POLYFIT_SUCCESS) {
+      return error;
+    }
+  } else {
+    accumulate_input(moments, x, y, w, 0, num_points, (double)x_offset,
+                     (double)x_scale);
+  }
+
+  error = validate_moments(moments);
+  if (error != POLYFIT_SUCCESS) {
+    return error;
+  }
+
+  if (ws != NULL) {
+    error = solve_moments(moments, degree, ws->matrix, ws->rhs, result_poly);
+  } else {
+    error = solve_moments(moments, degree, local_A, local_B, result_poly);
+  }
+  if (error != POLYFIT_SUCCESS) {
+    return error;
+  }
+
+  // The moments and coefficients share a domain, so the statistics need no
+  // further pass over the data
+  if (quality != NULL) {
+    moments_quality(moments, result_poly->coefficients, degree, quality);
+  }
+
+  if (config->normalize_domain) {
+    set_domain(result_poly, true, x_offset, x_scale);
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+static double moments_rss(const polyfit_moments_t* moments,
+                          const float* coeffs, int32_t degree) {
+  // sum (y - c^T v)^2 = sum y^2 - 2 c^T b + c^T A c, with A Hankel
+  double fitted = 0.0;
+  double quadratic = 0.0;
+  for (int32_t i = 0; i <= degree; i++) {
+    const double ci = (double)coeffs[i];
+    double row = 0.0;
+    for (int32_t j = 0; j <= degree; j++) {
+      row += moments->power_sums[i + j] * (double)coeffs[j];
+    }
+    fitted += ci * moments->cross_sums[i];
+    quadratic += ci * row;
+  }
+
+  const double value = moments->sum_y2 - 2.0 * fitted + quadratic;
+  return (value > 0.0) ? value : 0.0;
+}
+
+static void moments_quality(const polyfit_moments_t* moments,
+                            const float* coeffs, int32_t degree,
+                            polyfit_quality_t* quality) {
+  const double rss = moments_rss(moments, coeffs, degree);
+
+  // power_sums[0] is the point count, or the weight total of weighted
+  // moments, and cross_sums[0] the matching sum of y
+  const double total = moments->power_sums[0];
+  double tss = 0.0;
+  if (total > 0.0) {
+    tss = moments->sum_y2 -
+          moments->cross_sums[0] * moments->cross_sums[0] / total;
+    tss = (tss > 0.0) ? tss : 0.0;
+  }
+
+  const int64_t n = moments->num_points;
+  const int64_t k = (int64_t)degree + 1;
+  const double fn = (double)n;
+
+  quality->rss = rss;
+  quality->tss = tss;
+  quality->num_points = n;
+  quality->dof = n - k;
+
+  // Same conventions as polyfit_r_squared() for constant y
+  if (tss < 1e-20) {
+    quality->r_squared = (rss < 1e-20) ? 1.0f : 0.0f;
+  } else {
+    quality->r_squared = (float)(1.0 - rss / tss);
+  }
+
+  if (quality->dof > 0) {
+    quality->adj_r_squared =
+        (float)(1.0 - (1.0 - (double)quality->r_squared) * (fn - 1.0) /
+                          (double)quality->dof);
+    quality->residual_std_error = (float)sqrt(rss / (double)quality->dof);
+  } else {
+    quality->adj_r_squared = quality->r_squared;
+    quality->residual_std_error = 0.0f;
+  }
+
+  // As in polyfit_best_degree_moments(), RSS below float precision of y is
+  // rounding noise
+  const double rss_floor =
+      moments->sum_y2 * (double)FLT_EPSILON * (double)FLT_EPSILON;
+  const double rss_ic = (rss > rss_floor) ? rss : rss_floor;
+  if (rss_ic > 0.0) {
+    const double log_likelihood = fn * log(rss_ic / fn);
+    quality->aic = (float)(log_likelihood + 2.0 * (double)k);
+    quality->bic = (float)(log_likelihood + (double)k * log(fn));
+  } else {
+    quality->aic = -INFINITY;
+    quality->bic = -INFINITY;
+  }
+}
+
+static void* polyfit_alloc(size_t size) {
+  POLYFIT_STATS_COUNT(allocations, 1);
+  return g_allocator.alloc(size, g_allocator.user_data);
+}
+
+static void* polyfit_alloc_zeroed(size_t count, size_t size) {
+  if (size != 0 && count > SIZE_MAX / size) {
+    return NULL;
+  }
+
+  void* ptr = polyfit_alloc(count * size);
+  if (ptr != NULL) {
+    memset(ptr, 0, count * size);
+  }
+  return ptr;
+}
+
+static void polyfit_dealloc(void* ptr) {
+  if (ptr != NULL) {
+    g_allocator.free(ptr, g_allocator.user_data);
+  }
+}
+
+static void* default_alloc(size_t size, void* user_data) {
+  (void)user_data;
+  return malloc(size);
+}
+
+static void default_free(void* ptr, void* user_data) {
+  (void)user_data;
+  free(ptr);
+}
+
+static void set_domain(Polynomial* poly, bool is_normalized, float x_offset,
+                       float x_scale) {
+  poly->is_normalized = is_normalized;
+  poly->x_offset = x_offset;
+  poly->x_scale = x_scale;
+}
+
+static float horner_eval(const float* coeffs, int32_t degree, float t) {
+  float value = coeffs[degree];
+  for (int32_t i = degree - 1; i >= 0; i--) {
+    value = POLYFIT_FMAF(value, t, coeffs[i]);
+  }
+  return value;
+}
+
+static float estrin_eval(const float* coeffs, int32_t degree, float t) {
+  const float* c = coeffs;
+  const float t2 = t * t;
+  const float t4 = t2 * t2;
+  const float t8 = t4 * t4;
+
+  // Level 0 pairs c[i] + c[i+1] t are independent; each further level joins
+  // two neighbours with t^2, t^4 or t^8, so the chain is about log2(degree)
+  // multiply-adds deep. Written out per degree to keep every term in a
+  // register.
+#define PAIR(i) POLYFIT_FMAF(c[(i) + 1], t, c[(i)])
+  switch (degree) {
+    case 0:
+      return c[0];
+    case 1:
+      return PAIR(0);
+    case 2:
+      return POLYFIT_FMAF(c[2], t2, PAIR(0));
+    case 3:
+      return POLYFIT_FMAF(PAIR(2), t2, PAIR(0));
+    case 4:
+      return POLYFIT_FMAF(c[4], t4, POLYFIT_FMAF(PAIR(2), t2, PAIR(0)));
+    case 5:
+      return POLYFIT_FMAF(PAIR(4), t4, POLYFIT_FMAF(PAIR(2), t2, PAIR(0)));
+    case 6:
+      return POLYFIT_FMAF(POLYFIT_FMAF(c[6], t2, PAIR(4)), t4,
+                          POLYFIT_FMAF(PAIR(2), t2, PAIR(0)));
+    case 7:
+      return POLYFIT_FMAF(POLYFIT_FMAF(PAIR(6), t2, PAIR(4)), t4,
+                          POLYFIT_FMAF(PAIR(2), t2, PAIR(0)));
+    case 8:
+      return POLYFIT_FMAF(
+          c[8], t8,
+          POLYFIT_FMAF(POLYFIT_FMAF(PAIR(6), t2, PAIR(4)), t4,
+                       POLYFIT_FMAF(PAIR(2), t2, PAIR(0))));
+    case 9:
+      return POLYFIT_FMAF(
+          PAIR(8), t8,
+          POLYFIT_FMAF(POLYFIT_FMAF(PAIR(6), t2, PAIR(4)), t4,
+                       POLYFIT_FMAF(PAIR(2), t2, PAIR(0))));
+    case 10:
+      return POLYFIT_FMAF(
+          POLYFIT_FMAF(c[10], t2, PAIR(8)), t8,
+          POLYFIT_FMAF(POLYFIT_FMAF(PAIR(6), t2, PAIR(4)), t4,
+                       POLYFIT_FMAF(PAIR(2), t2, PAIR(0))));
+    default:
+      return horner_eval(coeffs, degree, t);
+  }
+#undef PAIR
+}
+
+static float poly_eval(const float* coeffs, int32_t degree, float t) {
+  return (degree >= POLYFIT_ESTRIN_MIN_DEGREE) ? estrin_eval(coeffs, degree, t)
+                                               : horner_eval(coeffs, degree, t);
+}
+
+static void horner_batch(const Polynomial* poly, const float* xs, float* out,
+                         int32_t num_points) {
+  const float* coeffs = poly->coefficients;
+  const int32_t degree = poly->degree;
+  // Raw polynomials use the identity map, which is exact in IEEE arithmetic
+  const float offset = poly->is_normalized ? poly->x_offset : 0.0f;
+  const float scale = poly->is_normalized ? poly->x_scale : 1.0f;
+  int32_t i = 0;
+
+  // Every width fuses exactly when POLYFIT_FMAF does (FP_FAST_FMAF), so a
+  // value never depends on its position in the array. AVX-512 implies
+  // FP_FAST_FMAF but not the 128/256-bit FMA instructions, so it finishes
+  // the array with one masked step instead of the narrower loops.
+#if defined(__AVX512F__)
+  const __m512 offset16 = _mm512_set1_ps(offset);
+  const __m512 scale16 = _mm512_set1_ps(scale);
+  for (; i + 16 <= num_points; i += 16) {
+    const __m512 xv =
+        _mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(xs + i), offset16), scale16);
+    __m512 acc = _mm512_set1_ps(coeffs[degree]);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      acc = _mm512_fmadd_ps(acc, xv, _mm512_set1_ps(coeffs[k]));
+    }
+    _mm512_storeu_ps(out + i, acc);
+  }
+  if (i < num_points) {
+    const __mmask16 mask = (__mmask16)((1u << (num_points - i)) - 1u);
+    const __m512 xv = _mm512_mul_ps(
+        _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, xs + i), offset16), scale16);
+    __m512 acc = _mm512_set1_ps(coeffs[degree]);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      acc = _mm512_fmadd_ps(acc, xv, _mm512_set1_ps(coeffs[k]));
+    }
+    _mm512_mask_storeu_ps(out + i, mask, acc);
+    i = num_points;
+  }
+#endif
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+  const __m256 offset8 = _mm256_set1_ps(offset);
+  const __m256 scale8 = _mm256_set1_ps(scale);
+  for (; i + 8 <= num_points; i += 8) {
+    const __m256 xv =
+        _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(xs + i), offset8), scale8);
+    __m256 acc = _mm256_set1_ps(coeffs[degree]);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+#if defined(__FMA__)
+      acc = _mm256_fmadd_ps(acc, xv, _mm256_set1_ps(coeffs[k]));
+#else
+      acc = _mm256_add_ps(_mm256_mul_ps(acc, xv), _mm256_set1_ps(coeffs[k]));
+#endif
+    }
+    _mm256_storeu_ps(out + i, acc);
+  }
+#endif
+
+#if defined(__SSE2__) && !defined(__AVX512F__)
+  const __m128 offset4 = _mm_set1_ps(offset);
+  const __m128 scale4 = _mm_set1_ps(scale);
+  for (; i + 4 <= num_points; i += 4) {
+    const __m128 xv =
+        _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(xs + i), offset4), scale4);
+    __m128 acc = _mm_set1_ps(coeffs[degree]);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+#if defined(__FMA__)
+      acc = _mm_fmadd_ps(acc, xv, _mm_set1_ps(coeffs[k]));
+#else
+      acc = _mm_add_ps(_mm_mul_ps(acc, xv), _mm_set1_ps(coeffs[k]));
+#endif
+    }
+    _mm_storeu_ps(out + i, acc);
+  }
+#endif
+
+  // Scalar tail (and the whole array on targets without SIMD)
+  for (; i < num_points; i++) {
+    const float xi = (xs[i] - offset) * scale;
+    float acc = coeffs[degree];
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      acc = POLYFIT_FMAF(acc, xi, coeffs[k]);
+    }
+    out[i] = acc;
+  }
+}
+
+static void bank_horner(const polyfit_bank_t* bank, const float* xs,
+                        bool shared_x, float* out) {
+  const int32_t n = bank->num_models;
+  const int32_t degree = bank->max_degree;
+  const size_t stride = (size_t)bank->stride;
+  const float* top = bank->coefficients + (size_t)degree * stride;
+  int32_t m = 0;
+
+  // Each lane is one model; the loop over k walks contiguous coefficient rows
+#if defined(__AVX512F__)
+  for (; m + 16 <= n; m += 16) {
+    const __m512 xraw =
+        shared_x ? _mm512_set1_ps(xs[0]) : _mm512_loadu_ps(xs + m);
+    const __m512 xv =
+        _mm512_mul_ps(_mm512_sub_ps(xraw, _mm512_loadu_ps(bank->x_offsets + m)),
+                      _mm512_loadu_ps(bank->x_scales + m));
+    __m512 acc = _mm512_loadu_ps(top + m);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      acc = _mm512_fmadd_ps(acc, xv,
+                            _mm512_loadu_ps(bank->coefficients + k * stride + m));
+    }
+    _mm512_storeu_ps(out + m, acc);
+  }
+#endif
+
+#if defined(__AVX2__)
+  for (; m + 8 <= n; m += 8) {
+    const __m256 xraw =
+        shared_x ? _mm256_set1_ps(xs[0]) : _mm256_loadu_ps(xs + m);
+    const __m256 xv =
+        _mm256_mul_ps(_mm256_sub_ps(xraw, _mm256_loadu_ps(bank->x_offsets + m)),
+                      _mm256_loadu_ps(bank->x_scales + m));
+    __m256 acc = _mm256_loadu_ps(top + m);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      const __m256 ck = _mm256_loadu_ps(bank->coefficients + k * stride + m);
+#if defined(__FMA__)
+      acc = _mm256_fmadd_ps(acc, xv, ck);
+#else
+      acc = _mm256_add_ps(_mm256_mul_ps(acc, xv), ck);
+#endif
+    }
+    _mm256_storeu_ps(out + m, acc);
+  }
+#endif
+
+#if defined(__SSE2__)
+  for (; m + 4 <= n; m += 4) {
+    const __m128 xraw = shared_x ? _mm_set1_ps(xs[0]) : _mm_loadu_ps(xs + m);
+    const __m128 xv =
+        _mm_mul_ps(_mm_sub_ps(xraw, _mm_loadu_ps(bank->x_offsets + m)),
+                   _mm_loadu_ps(bank->x_scales + m));
+    __m128 acc = _mm_loadu_ps(top + m);
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      acc = _mm_add_ps(_mm_mul_ps(acc, xv),
+                       _mm_loadu_ps(bank->coefficients + k * stride + m));
+    }
+    _mm_storeu_ps(out + m, acc);
+  }
+#endif
+
+  for (; m < n; m++) {
+    const float xm =
+        ((shared_x ? xs[0] : xs[m]) - bank->x_offsets[m]) * bank->x_scales[m];
+    float acc = top[m];
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      acc = acc * xm + bank->coefficients[k * stride + m];
+    }
+    out[m] = acc;
+  }
+}
+
+/**
+ * @brief Thin QR factorization of the normalized Vandermonde matrix
+ *
+ * Modified Gram-Schmidt with one reorthogonalization pass, in double. A
+ * column that loses all but 1e-12 of its norm to the earlier ones means the
+ * grid has too few distinct points for the degree.
+ */
+static polyfit_error_t plan_factor(
+    const float* x, int32_t num_points, int32_t size, double x_offset,
+    double x_scale, double* q,
+    double r[POLYFIT_MAX_DEGREE + 1][POLYFIT_MAX_DEGREE + 1]) {
+  for (int32_t j = 0; j < size; j++) {
+    double* column = q + (size_t)j * num_points;
+    double norm_in = 0.0;
+    for (int32_t k = 0; k < num_points; k++) {
+      const double t = ((double)x[k] - x_offset) * x_scale;
+      double power = 1.0;
+      for (int32_t e = 0; e < j; e++) {
+        power *= t;
+      }
+      column[k] = power;
+      norm_in += power * power;
+    }
+
+    for (int32_t i = 0; i < size; i++) {
+      r[i][j] = 0.0;
+    }
+    for (int32_t pass = 0; pass < 2; pass++) {
+      for (int32_t i = 0; i < j; i++) {
+        const double* basis = q + (size_t)i * num_points;
+        double dot = 0.0;
+        for (int32_t k = 0; k < num_points; k++) {
+          dot += basis[k] * column[k];
+        }
+        for (int32_t k = 0; k < num_points; k++) {
+          column[k] -= dot * basis[k];
+        }
+        r[i][j] += dot;
+      }
+    }
+
+    double norm = 0.0;
+    for (int32_t k = 0; k < num_points; k++) {
+      norm += column[k] * column[k];
+    }
+    if (!(norm > 1e-24 * norm_in)) {
+      return POLYFIT_ERROR_SINGULAR_MATRIX;
+    }
+    norm = sqrt(norm);
+    r[j][j] = norm;
+    for (int32_t k = 0; k < num_points; k++) {
+      column[k] /= norm;
+    }
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+static void plan_project(const polyfit_plan_t* plan, const float* ys,
+                         int32_t num_series, float* coeffs) {
+  const int32_t n = plan->num_points;
+  const int32_t size = plan->degree + 1;
+
+  for (int32_t i = 0; i < num_series * size; i++) {
+    coeffs[i] = 0.0f;
+  }
+
+  // Walk the points in blocks so the projection block stays in cache while
+  // it is applied to every series; series go four at a time to reuse each
+  // projection load
+  for (int32_t start = 0; start < n; start += POLYFIT_BLOCK_SIZE) {
+    const int32_t end = (start + POLYFIT_BLOCK_SIZE < n)
+                            ? start + POLYFIT_BLOCK_SIZE
+                            : n;
+    int32_t s = 0;
+
+    for (; s + 4 <= num_series; s += 4) {
+      const float* y0 = ys + (size_t)s * n;
+      const float* y1 = y0 + n;
+      const float* y2 = y1 + n;
+      const float* y3 = y2 + n;
+
+      for (int32_t i = 0; i < size; i++) {
+        const float* row = plan->projection + (size_t)i * n;
+        float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+        for (int32_t k = start; k < end; k++) {
+          sum0 += row[k] * y0[k];
+          sum1 += row[k] * y1[k];
+          sum2 += row[k] * y2[k];
+          sum3 += row[k] * y3[k];
+        }
+        coeffs[(s + 0) * size + i] += sum0;
+        coeffs[(s + 1) * size + i] += sum1;
+        coeffs[(s + 2) * size + i] += sum2;
+        coeffs[(s + 3) * size + i] += sum3;
+      }
+    }
+
+    for (; s < num_series; s++) {
+      const float* y = ys + (size_t)s * n;
+      for (int32_t i = 0; i < size; i++) {
+        const float* row = plan->projection + (size_t)i * n;
+        float sum = 0.0f;
+        for (int32_t k = start; k < end; k++) {
+          sum += row[k] * y[k];
+        }
+        coeffs[s * size + i] += sum;
+      }
+    }
+  }
+}
+
+static void moments_reset(polyfit_moments_t* moments, int32_t degree) {
+  for (int32_t k = 0; k < 2 * POLYFIT_MAX_DEGREE + 1; k++) {
+    moments->power_sums[k] = 0.0;
+  }
+  for (int32_t k = 0; k < POLYFIT_MAX_DEGREE + 1; k++) {
+    moments->cross_sums[k] = 0.0;
+  }
+  moments->sum_y2 = 0.0;
+  moments->degree = degree;
+  moments->num_points = 0;
+}
+
+static void accumulate_moments(polyfit_moments_t* moments, const float* x,
+                               const float* y, int32_t num_points,
+                               double x_offset, double x_scale) {
+  const polyfit_input_t x_in = polyfit_input(x, POLYFIT_TYPE_FLOAT);
+  const polyfit_input_t y_in = polyfit_input(y, POLYFIT_TYPE_FLOAT);
+  accumulate_input(moments, &x_in, &y_in, NULL, 0, num_points, x_offset,
+                   x_scale);
+}
+
+/**
+ * @brief Convert count elements of one type, dense or strided
+ *
+ * A stride of 0 means the elements are packed. Strided elements are read
+ * with memcpy so record layouts need not be aligned for the element type.
+ */
+#define POLYFIT_LOAD_CASE(TYPE, CONVERT)                                     \
+  do {                                                                       \
+    if (in->stride == 0) {                                                   \
+      const TYPE* data = (const TYPE*)in->data + start;                      \
+      for (int32_t i = 0; i < count; i++) {                                  \
+        const TYPE raw = data[i];                                            \
+        out[i] = (CONVERT) * scale + offset;                                 \
+      }                                                                      \
+    } else {                                                                 \
+      const char* bytes =                                                    \
+          (const char*)in->data + (ptrdiff_t)start * in->stride;             \
+      for (int32_t i = 0; i < count; i++) {                                  \
+        TYPE raw;                                                            \
+        memcpy(&raw, bytes + (ptrdiff_t)i * in->stride, sizeof(TYPE));       \
+        out[i] = (CONVERT) * scale + offset;                                 \
+      }                                                                      \
+    }                                                                        \
+  } while (0)
+
+static void load_input(const polyfit_input_t* in, int32_t start,
+                       int32_t count, double* out) {
+  const double scale = in->scale;
+  const double offset = in->offset;
+  const int64_t origin = in->origin;
+
+  // One switch per block keeps the type dispatch out of the per-point loop
+  switch (in->type) {
+    case POLYFIT_TYPE_FLOAT:
+      POLYFIT_LOAD_CASE(float, (double)raw);
+      break;
+    case POLYFIT_TYPE_DOUBLE:
+      POLYFIT_LOAD_CASE(double, raw);
+      break;
+    case POLYFIT_TYPE_INT16:
+      POLYFIT_LOAD_CASE(int16_t, (double)raw);
+      break;
+    case POLYFIT_TYPE_UINT16:
+      POLYFIT_LOAD_CASE(uint16_t, (double)raw);
+      break;
+    case POLYFIT_TYPE_INT32:
+      POLYFIT_LOAD_CASE(int32_t, (double)raw);
+      break;
+    case POLYFIT_TYPE_INT64:
+      // Rebase in integer arithmetic so the double conversion sees only the
+      // small distance from the origin
+      POLYFIT_LOAD_CASE(int64_t, (double)(raw - origin));
+      break;
+    case POLYFIT_TYPE_INDEX:
+      for (int32_t i = 0; i < count; i++) {
+        out[i] = (double)(start + i) * scale + offset;
+      }
+      break;
+    default:
+      for (int32_t i = 0; i < count; i++) {
+        out[i] = NAN;
+      }
+      break;
+  }
+}
+
+#undef POLYFIT_LOAD_CASE
+
+static bool input_valid(const polyfit_input_t* in) {
+  return in->type >= POLYFIT_TYPE_FLOAT && in->type <= POLYFIT_TYPE_INDEX &&
+         in->stride >= 0;
+}
+
+static bool input_has_data(const polyfit_input_t* in) {
+  return in->data != NULL || in->type == POLYFIT_TYPE_INDEX;
+}
+
+static void load_input_float(const polyfit_input_t* in, int32_t start,
+                             int32_t count, float* out) {
+  double block[POLYFIT_BLOCK_SIZE];
+  load_input(in, start, count, block);
+  for (int32_t i = 0; i < count; i++) {
+    out[i] = (float)block[i];
+  }
+}
+
+static void accumulate_input(polyfit_moments_t* moments,
+                             const polyfit_input_t* x,
+                             const polyfit_input_t* y,
+                             const polyfit_input_t* w, int32_t start,
+                             int32_t num_points, double x_offset,
+                             double x_scale) {
+  POLYFIT_STATS_TIMESTAMP(accumulate_start);
+  accumulate_range(moments, x, y, w, start, num_points, x_offset, x_scale);
+  POLYFIT_STATS_ACCUMULATE(num_points, accumulate_start);
+}
+
+static void accumulate_range(polyfit_moments_t* moments,
+                             const polyfit_input_t* x,
+                             const polyfit_input_t* y,
+                             const polyfit_input_t* w, int32_t start,
+                             int32_t num_points, double x_offset,
+                             double x_scale) {
+  // Degree 0 still tracks sum(x) so non-finite x values are detected
+  const int32_t num_power =
+      (moments->degree > 0) ? 2 * moments->degree + 1 : 2;
+  const int32_t num_cross = moments->degree + 1;
+
+  // Accumulate into locals so the compiler need not assume aliasing with x/y
+  double power[2 * POLYFIT_MAX_DEGREE + 1] = {0.0};
+  double cross[POLYFIT_MAX_DEGREE + 1] = {0.0};
+  double sum_y2 = 0.0;
+
+  double xb[POLYFIT_BLOCK_SIZE];
+  double yb[POLYFIT_BLOCK_SIZE];
+  double wb[POLYFIT_BLOCK_SIZE];
+  bool negative_weight = false;
+
+  for (int32_t base = 0; base < num_points; base += POLYFIT_BLOCK_SIZE) {
+    int32_t count = num_points - base;
+    if (count > POLYFIT_BLOCK_SIZE) {
+      count = POLYFIT_BLOCK_SIZE;
+    }
+    load_input(x, start + base, count, xb);
+    load_input(y, start + base, count, yb);
+
+    if (w != NULL) {
+      // Each weight scales its point's whole contribution, exactly as if
+      // the point were repeated w times
+      load_input(w, start + base, count, wb);
+      for (int32_t k = 0; k < count; k++) {
+        const double xk = (xb[k] - x_offset) * x_scale;
+        const double yk = yb[k];
+        const double wk = wb[k];
+        double p = wk;
+        int32_t i = 0;
+
+        negative_weight |= (wk < 0.0);
+        sum_y2 += wk * yk * yk;
+        for (; i < num_cross; i++) {
+          power[i] += p;
+          cross[i] += p * yk;
+          p *= xk;
+        }
+        for (; i < num_power; i++) {
+          power[i] += p;
+          p *= xk;
+        }
+      }
+      continue;
+    }
+
+    for (int32_t k = 0; k < count; k++) {
+      const double xk = (xb[k] - x_offset) * x_scale;
+      const double yk = yb[k];
+      double p = 1.0;
+      int32_t i = 0;
+
+      sum_y2 += yk * yk;
+      for (; i < num_cross; i++) {
+        power[i] += p;
+        cross[i] += p * yk;
+        p *= xk;
+      }
+      for (; i < num_power; i++) {
+        power[i] += p;
+        p *= xk;
+      }
+    }
+  }
+
+  for (int32_t i = 0; i < num_power; i++) {
+    moments->power_sums[i] += power[i];
+  }
+  for (int32_t i = 0; i < num_cross; i++) {
+    moments->cross_sums[i] += cross[i];
+  }
+  moments->sum_y2 += sum_y2;
+  moments->num_points += num_points;
+
+  // A negative weight poisons the sums so validate_moments() rejects them
+  if (negative_weight) {
+    moments->power_sums[0] = NAN;
+  }
+}
+
+static polyfit_error_t validate_moments(const polyfit_moments_t* moments) {
+  const int32_t num_power =
+      (moments->degree > 0) ? 2 * moments->degree + 1 : 2;
+
+  // Check for NaN or infinite values (inputs or overflowed powers)
+  for (int32_t i = 0; i < num_power; i++) {
+    if (!isfinite(moments->power_sums[i])) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+  }
+  for (int32_t i = 0; i <= moments->degree; i++) {
+    if (!isfinite(moments->cross_sums[i])) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+  }
+  if (!isfinite(moments->sum_y2)) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  return POLYFIT_SUCCESS;
+}
+
+/**
+ * @brief Work description for one parallel accumulation thread
+ */
+typedef struct {
+  polyfit_moments_t* blocks; /**< Per-block moments, shared by all threads */
+  const polyfit_input_t* x;
+  const polyfit_input_t* y;
+  const polyfit_input_t* w; /**< Weights, or NULL */
+  int32_t num_points;
+  int32_t first_block; /**< First block this thread accumulates */
+  int32_t end_block;   /**< One past the last block */
+  double x_offset;
+  double x_scale;
+} parallel_task_t;
+
+static void* accumulate_blocks(void* arg) {
+  parallel_task_t* task = (parallel_task_t*)arg;
+
+  for (int32_t b = task->first_block; b < task->end_block; b++) {
+    const int32_t start = b * POLYFIT_PARALLEL_BLOCK_SIZE;
+    int32_t count = task->num_points - start;
+    if (count > POLYFIT_PARALLEL_BLOCK_SIZE) {
+      count = POLYFIT_PARALLEL_BLOCK_SIZE;
+    }
+    accumulate_range(&task->blocks[b], task->x, task->y, task->w, start,
+                     count, task->x_offset, task->x_scale);
+  }
+
+  return NULL;
+}
+
+static polyfit_error_t accumulate_moments_parallel(
+    polyfit_moments_t* moments, const polyfit_input_t* x,
+    const polyfit_input_t* y, const polyfit_input_t* w, int32_t num_points,
+    double x_offset, double x_scale, int32_t num_threads,
+    const polyfit_allocator_t* allocator) {
+  if (allocator == NULL) {
+    allocator = &g_allocator;
+  }
+
+  POLYFIT_STATS_TIMESTAMP(accumulate_start);
+  const int32_t num_blocks =
+      (num_points + POLYFIT_PARALLEL_BLOCK_SIZE - 1) /
+      POLYFIT_PARALLEL_BLOCK_SIZE;
+
+  // Block boundaries depend only on num_points, never on the thread count
+  polyfit_moments_t* blocks = (polyfit_moments_t*)allocator->alloc(
+      (size_t)num_blocks * sizeof(polyfit_moments_t), allocator->user_data);
+  if (blocks == NULL) {
+    return POLYFIT_ERROR_MEMORY_ALLOC;
+  }
+  POLYFIT_STATS_COUNT(allocations, 1);
+  for (int32_t b = 0; b < num_blocks; b++) {
+    moments_reset(&blocks[b], moments->degree);
+  }
+
+  if (num_threads > num_blocks) {
+    num_threads = num_blocks;
+  }
+
+  parallel_task_t tasks[POLYFIT_MAX_THREADS];
+  if (num_threads > POLYFIT_MAX_THREADS) {
+    num_threads = POLYFIT_MAX_THREADS;
+  }
+
+  for (int32_t t = 0; t < num_threads; t++) {
+    tasks[t].blocks = blocks;
+    tasks[t].x = x;
+    tasks[t].y = y;
+    tasks[t].w = w;
+    tasks[t].num_points = num_points;
+    tasks[t].first_block = (int32_t)((int64_t)num_blocks * t / num_threads);
+    tasks[t].end_block = (int32_t)((int64_t)num_blocks * (t + 1) / num_threads);
+    tasks[t].x_offset = x_offset;
+    tasks[t].x_scale = x_scale;
+  }
+
+#if defined(POLYFIT_ENABLE_THREADS)
+  // Threads 1..n-1 run as workers; the calling thread takes task 0. A worker
+  // that fails to start has its blocks run inline instead.
+  pthread_t threads[POLYFIT_MAX_THREADS];
+  bool started[POLYFIT_MAX_THREADS] = {false};
+  for (int32_t t = 1; t < num_threads; t++) {
+    started[t] =
+        (pthread_create(&threads[t], NULL, accumulate_blocks, &tasks[t]) == 0);
+  }
+  accumulate_blocks(&tasks[0]);
+  for (int32_t t = 1; t < num_threads; t++) {
+    if (started[t]) {
+      pthread_join(threads[t], NULL);
+    } else {
+      accumulate_blocks(&tasks[t]);
+    }
   }
+#else
+  for (int32_t t = 0; t < num_threads; t++) {
+    accumulate_blocks(&tasks[t]);
+  }
+#endif
 
-  if (error != NULL) {
-    *error = POLYFIT_SUCCESS;
+  // Fixed pairwise tree: identical summation order for any thread count
+  for (int32_t step = 1; step < num_blocks; step *= 2) {
+    for (int32_t b = 0; b + step < num_blocks; b += 2 * step) {
+      merge_moments(&blocks[b], &blocks[b + step]);
+    }
   }
+  merge_moments(moments, &blocks[0]);
 
-  return best_poly;
+  allocator->free(blocks, allocator->user_data);
+  POLYFIT_STATS_ACCUMULATE(num_points, accumulate_start);
+
+  return POLYFIT_SUCCESS;
 }
 
-/*============================================================================*/
-/* UTILITY FUNCTION IMPLEMENTATIONS                                          */
-/*============================================================================*/
+static void update_moments(polyfit_moments_t* moments, float x, float y,
+                           double sign) {
+  const int32_t num_power =
+      (moments->degree > 0) ? 2 * moments->degree + 1 : 2;
+  const double xd = (double)x;
+  const double yd = (double)y;
+  double p = sign;
 
-float polyfit_pow(float base, int32_t exponent) {
-  // Handle special cases
-  if (exponent == 0) {
-    return 1.0f;
+  moments->sum_y2 += sign * yd * yd;
+  for (int32_t i = 0; i < num_power; i++) {
+    moments->power_sums[i] += p;
+    if (i <= moments->degree) {
+      moments->cross_sums[i] += p * yd;
+    }
+    p *= xd;
   }
+}
 
-  if (base == 0.0f) {
-    return (exponent > 0) ? 0.0f : 1.0f;  // 0^0 = 1 by convention
+static void merge_moments(polyfit_moments_t* dst,
+                          const polyfit_moments_t* src) {
+  for (int32_t i = 0; i < 2 * POLYFIT_MAX_DEGREE + 1; i++) {
+    dst->power_sums[i] += src->power_sums[i];
   }
+  for (int32_t i = 0; i < POLYFIT_MAX_DEGREE + 1; i++) {
+    dst->cross_sums[i] += src->cross_sums[i];
+  }
+  dst->sum_y2 += src->sum_y2;
+  dst->num_points += src->num_points;
+}
 
-  if (base == 1.0f) {
-    return 1.0f;
+static void window_rebuild(polyfit_window_t* win) {
+  int32_t oldest = win->head;
+  int32_t newest = (win->head + win->count - 1) % win->capacity;
+
+  win->x_origin =
+      0.5f * win->x_values[oldest] + 0.5f * win->x_values[newest];
+  polyfit_accumulator_reset(&win->acc);
+
+  for (int32_t k = 0; k < win->count; k++) {
+    int32_t slot = (win->head + k) % win->capacity;
+    polyfit_accumulator_add_point(&win->acc, win->x_values[slot] - win->x_origin,
+                                  win->y_values[slot]);
   }
+  win->since_rebuild = 0;
+}
 
-  if (base == -1.0f) {
-    return (exponent % 2 == 0) ? 1.0f : -1.0f;
+/**
+ * @brief p(x) and dp/dx in one Horner pass, in double
+ */
+static void eval_with_derivative(const Polynomial* poly, double x,
+                                 double* value, double* derivative) {
+  double t = x;
+  double scale = 1.0;
+  if (poly->is_normalized) {
+    scale = (double)poly->x_scale;
+    t = (x - (double)poly->x_offset) * scale;
   }
 
-  // Use binary exponentiation
-  float result = 1.0f;
-  float current_base = base;
-  int32_t abs_exponent = (exponent < 0) ? -exponent : exponent;
+  double p = (double)poly->coefficients[poly->degree];
+  double dp = 0.0;
+  for (int32_t k = poly->degree - 1; k >= 0; k--) {
+    dp = dp * t + p;
+    p = p * t + (double)poly->coefficients[k];
+  }
 
-  while (abs_exponent > 0) {
-    if (abs_exponent & 1) {
-      result *= current_base;
+  *value = p;
+  *derivative = dp * scale;
+}
+
+/**
+ * @brief Safeguarded Newton solve of p(x) = y on a bracket
+ *
+ * f_lo = p(lo) - y must differ in sign from p(hi) - y. The bracket shrinks
+ * with every evaluation; a Newton step that would leave it, or that is not
+ * at least halving the previous step, is replaced by bisection.
+ */
+static double inverse_solve(const Polynomial* poly, double y, double lo,
+                            double hi, double f_lo, double guess) {
+  if (f_lo == 0.0) {
+    return lo;
+  }
+
+  // Orient the bracket so that f(neg) < 0 < f(pos)
+  double neg = (f_lo < 0.0) ? lo : hi;
+  double pos = (f_lo < 0.0) ? hi : lo;
+  double x = (guess >= lo && guess <= hi) ? guess : 0.5 * (lo + hi);
+  double step = hi - lo;
+  double last_step = step;
+
+  for (int32_t iter = 0; iter < POLYFIT_INVERSE_MAX_ITERATIONS; iter++) {
+    double f;
+    double df;
+    eval_with_derivative(poly, x, &f, &df);
+    f -= y;
+    if (f == 0.0) {
+      return x;
+    }
+    if (f < 0.0) {
+      neg = x;
+    } else {
+      pos = x;
+    }
+
+    double next = x - f / df;
+    const bool outside = !((next - neg) * (next - pos) <= 0.0);
+    if (outside || fabs(2.0 * f) > fabs(last_step * df)) {
+      last_step = step;
+      step = 0.5 * (pos - neg);
+      next = neg + step;
+    } else {
+      last_step = step;
+      step = next - x;
+    }
+
+    // Converged once a step is below the float resolution of x
+    const double tolerance = 0.25 * (double)FLT_EPSILON * fabs(next) +
+                             (double)FLT_MIN;
+    x = next;
+    if (fabs(step) <= tolerance || fabs(pos - neg) <= tolerance) {
+      break;
     }
-    current_base *= current_base;
-    abs_exponent >>= 1;
   }
 
-  return (exponent < 0) ? (1.0f / result) : result;
+  return x;
 }
 
-float polyfit_fabs(float x) {
-  // Handle NaN
-  if (x != x) {
-    return x;
+/**
+ * @brief p(t), p'(t) and p''(t) with one fused Horner recurrence
+ */
+static void horner_derivatives(const float* coeffs, int32_t degree, float t,
+                               float* value, float* first, float* second) {
+  float p = coeffs[degree];
+  float dp = 0.0f;
+  float ddp = 0.0f;
+  for (int32_t k = degree - 1; k >= 0; k--) {
+    ddp = POLYFIT_FMAF(ddp, t, dp);
+    dp = POLYFIT_FMAF(dp, t, p);
+    p = POLYFIT_FMAF(p, t, coeffs[k]);
   }
 
-  // Use bit manipulation for efficiency
-  union {
-    float f;
-    uint32_t i;
-  } u;
+  // The recurrence accumulates p''/2
+  *value = p;
+  *first = dp;
+  *second = 2.0f * ddp;
+}
 
-  u.f = x;
-  u.i &= 0x7FFFFFFF;  // Clear sign bit
+/**
+ * @brief Antiderivative of p at x in double, zero at the domain origin
+ */
+static double antiderivative_eval(const Polynomial* poly, double x) {
+  double t = x;
+  double scale = 1.0;
+  if (poly->is_normalized) {
+    scale = (double)poly->x_scale;
+    t = (x - (double)poly->x_offset) * scale;
+  }
 
-  return u.f;
+  // sum c_k t^(k+1) / (k+1), then dx = dt / x_scale
+  double sum = 0.0;
+  for (int32_t k = poly->degree; k >= 0; k--) {
+    sum = sum * t + (double)poly->coefficients[k] / (double)(k + 1);
+  }
+
+  return sum * t / scale;
 }
 
-bool polyfit_is_nearly_zero(float value, float threshold) {
-  return polyfit_fabs(value) < threshold;
+/**
+ * @brief Fractional bits that hold |value| <= bound below 2^30
+ *
+ * One bit of headroom below the int32 limit absorbs rounding; the result is
+ * capped at 60 so that zero or tiny bounds give finite shifts.
+ */
+static int32_t fixed_frac_bits(double bound) {
+  if (!(bound > 0.0)) {
+    return 60;
+  }
+
+  int exponent;
+  frexp(bound, &exponent);  // bound < 2^exponent
+  const int32_t bits = 30 - (int32_t)exponent;
+  return (bits < 60) ? bits : 60;
 }
 
-/*============================================================================*/
-/* PRIVATE FUNCTION IMPLEMENTATIONS                                          */
-/*============================================================================*/
+/**
+ * @brief Round-to-nearest arithmetic shift; a negative shift moves left
+ */
+static int64_t fixed_shift(int64_t value, int32_t shift) {
+  if (shift <= 0) {
+    return (shift > -63) ? value * ((int64_t)1 << -shift) : 0;
+  }
 
-static polyfit_error_t gaussian_elimination(float** A, float* B, float* x,
-                                            int32_t n) {
-  if (A == NULL || B == NULL || x == NULL || n <= 0) {
-    return POLYFIT_ERROR_NULL_POINTER;
+  if (shift >= 63) {
+    return 0;
   }
 
-  const float pivot_threshold = 1e-12f;
+  // Signed right shift is arithmetic on every supported compiler
+  return (value + ((int64_t)1 << (shift - 1))) >> shift;
+}
 
-  // Forward elimination with partial pivoting
-  for (int32_t i = 0; i < n; i++) {
-    // Find pivot
-    int32_t max_row = i;
-    for (int32_t k = i + 1; k < n; k++) {
-      if (polyfit_fabs(A[k][i]) > polyfit_fabs(A[max_row][i])) {
-        max_row = k;
-      }
-    }
+static polyfit_piecewise_t* piecewise_create(int32_t num_segments,
+                                             int32_t degree) {
+  polyfit_piecewise_t* pw =
+      (polyfit_piecewise_t*)polyfit_alloc(sizeof(polyfit_piecewise_t));
+  if (pw == NULL) {
+    return NULL;
+  }
 
-    // Check for singular matrix
-    if (polyfit_fabs(A[max_row][i]) < pivot_threshold) {
-      return POLYFIT_ERROR_SINGULAR_MATRIX;
-    }
+  // Coefficients, breakpoints and inverse widths share one block
+  const size_t size = (size_t)degree + 1;
+  const size_t num_floats =
+      (size_t)num_segments * size + (size_t)num_segments + 1 +
+      (size_t)num_segments;
+  pw->coefficients = (float*)polyfit_alloc_zeroed(num_floats, sizeof(float));
+  pw->buckets = (int32_t*)polyfit_alloc_zeroed(
+      2 * (size_t)num_segments + 1, sizeof(int32_t));
+  if (pw->coefficients == NULL || pw->buckets == NULL) {
+    polyfit_dealloc(pw->coefficients);
+    polyfit_dealloc(pw->buckets);
+    polyfit_dealloc(pw);
+    return NULL;
+  }
 
-    // Swap rows
-    if (max_row != i) {
-      float* temp_row = A[i];
-      A[i] = A[max_row];
-      A[max_row] = temp_row;
+  pw->breakpoints = pw->coefficients + (size_t)num_segments * size;
+  pw->inv_widths = pw->breakpoints + num_segments + 1;
+  pw->bucket_scale = 0.0f;
+  pw->num_buckets = 0;
+  pw->num_segments = num_segments;
+  pw->degree = degree;
 
-      float temp_b = B[i];
-      B[i] = B[max_row];
-      B[max_row] = temp_b;
+  return pw;
+}
+
+/**
+ * @brief Uniform bucket holding x, clamped to the index range
+ */
+static int32_t piecewise_bucket(const polyfit_piecewise_t* pw, float x) {
+  const float u = (x - pw->breakpoints[0]) * pw->bucket_scale;
+  if (!(u > 0.0f)) {
+    return 0;
+  }
+  return (u < (float)pw->num_buckets) ? (int32_t)u : pw->num_buckets - 1;
+}
+
+static void piecewise_build_index(polyfit_piecewise_t* pw) {
+  const float* knots = pw->breakpoints;
+  const int32_t num_segments = pw->num_segments;
+
+  pw->num_buckets = 2 * num_segments;
+  pw->bucket_scale =
+      (float)pw->num_buckets / (knots[num_segments] - knots[0]);
+
+  // buckets[b] is the last segment whose start falls in an earlier bucket.
+  // Built with the lookup's own rounding, a point in bucket b always lies in
+  // segments buckets[b] to buckets[b + 1].
+  int32_t segment = 0;
+  for (int32_t b = 0; b <= pw->num_buckets; b++) {
+    while (segment + 1 < num_segments &&
+           piecewise_bucket(pw, knots[segment + 1]) < b) {
+      segment++;
     }
+    pw->buckets[b] = segment;
+  }
+}
 
-    // Eliminate column
-    for (int32_t k = i + 1; k < n; k++) {
-      float factor = A[k][i] / A[i][i];
-      for (int32_t j = i; j < n; j++) {
-        A[k][j] -= factor * A[i][j];
-      }
-      B[k] -= factor * B[i];
+static int32_t piecewise_locate(const polyfit_piecewise_t* pw, float x) {
+  const int32_t b = piecewise_bucket(pw, x);
+  int32_t segment = pw->buckets[b];
+  int32_t len = pw->buckets[b + 1] - segment;
+
+  // Last segment in [segment, segment + len] starting at or before x; the
+  // select compiles to a conditional move
+  while (len > 0) {
+    const int32_t half = (len + 1) / 2;
+    segment = (pw->breakpoints[segment + half] <= x) ? segment + half : segment;
+    len -= half;
+  }
+
+  return segment;
+}
+
+static float piecewise_horner(const polyfit_piecewise_t* pw, int32_t segment,
+                              float x) {
+  const float* coeffs = pw->coefficients + (size_t)segment * (pw->degree + 1);
+  const float t = (x - pw->breakpoints[segment]) * pw->inv_widths[segment];
+
+  float result = coeffs[pw->degree];
+  for (int32_t k = pw->degree - 1; k >= 0; k--) {
+    result = result * t + coeffs[k];
+  }
+  return result;
+}
+
+static polyfit_error_t piecewise_solve(const polyfit_moments_t* moments,
+                                       int32_t degree, bool pinned,
+                                       float pin_value, float* coeffs) {
+  float A[(POLYFIT_MAX_DEGREE + 1) * (POLYFIT_MAX_DEGREE + 1)];
+  float B[POLYFIT_MAX_DEGREE + 1];
+
+  if (!pinned) {
+    Polynomial view = {.coefficients = coeffs, .degree = degree};
+    return solve_moments(moments, degree, A, B, &view);
+  }
+
+  // With c0 fixed, minimise sum (y - c0 - sum_{k>=1} c_k t^k)^2 over c_1..c_d:
+  // the normal equations drop row and column 0 and move c0 to the right
+  coeffs[0] = pin_value;
+  const int32_t size = degree;
+  if (size == 0) {
+    return POLYFIT_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < size; i++) {
+    for (int32_t j = 0; j < size; j++) {
+      A[i * size + j] = (float)moments->power_sums[i + j + 2];
     }
+    B[i] = (float)(moments->cross_sums[i + 1] -
+                   (double)pin_value * moments->power_sums[i + 1]);
   }
 
-  // Back substitution
-  for (int32_t i = n - 1; i >= 0; i--) {
-    x[i] = B[i];
-    for (int32_t j = i + 1; j < n; j++) {
-      x[i] -= A[i][j] * x[j];
+  return gaussian_elimination(A, B, coeffs + 1, size);
+}
+
+static polyfit_error_t piecewise_fit_range(const float* x, const float* y,
+                                           int32_t start, int32_t count,
+                                           float left, float inv_width,
+                                           int32_t degree, bool pinned,
+                                           float pin_value, float* coeffs,
+                                           float* max_residual) {
+  polyfit_moments_t moments;
+  moments_reset(&moments, degree);
+  accumulate_moments(&moments, x + start, y + start, count, (double)left,
+                     (double)inv_width);
+
+  polyfit_error_t error = validate_moments(&moments);
+  if (error != POLYFIT_SUCCESS) {
+    return error;
+  }
+
+  error = piecewise_solve(&moments, degree, pinned, pin_value, coeffs);
+  if (error != POLYFIT_SUCCESS || max_residual == NULL) {
+    return error;
+  }
+
+  float worst = 0.0f;
+  for (int32_t i = start; i < start + count; i++) {
+    const float t = (x[i] - left) * inv_width;
+    float y_hat = coeffs[degree];
+    for (int32_t k = degree - 1; k >= 0; k--) {
+      y_hat = y_hat * t + coeffs[k];
     }
-    x[i] /= A[i][i];
+    const float residual = polyfit_fabs(y_hat - y[i]);
+    worst = (residual > worst) ? residual : worst;
   }
+  *max_residual = worst;
 
   return POLYFIT_SUCCESS;
 }
 
-static polyfit_error_t allocate_matrix(float*** matrix, int32_t rows,
-                                       int32_t cols) {
-  if (matrix == NULL || rows <= 0 || cols <= 0) {
-    return POLYFIT_ERROR_NULL_POINTER;
+/**
+ * @brief Whether points start to start + len - 1 fit within max_residual
+ *
+ * The candidate segment ends at x[start + len], where the next segment would
+ * begin, or at the last point. When the next segment will be pinned, the
+ * value at that knot must also be within the target of its data point, or
+ * the pinned segment could not meet it.
+ */
+static bool piecewise_candidate_fits(const piecewise_greedy_t* g,
+                                     int32_t start, int32_t len) {
+  const int32_t end = start + len;
+  const float left = g->x[start];
+  const float right = (end < g->num_points) ? g->x[end]
+                                            : g->x[g->num_points - 1];
+  if (!(right > left)) {
+    return false;
   }
 
-  *matrix = (float**)malloc(rows * sizeof(float*));
-  if (*matrix == NULL) {
-    return POLYFIT_ERROR_MEMORY_ALLOC;
+  float worst;
+  if (piecewise_fit_range(g->x, g->y, start, len, left, 1.0f / (right - left),
+                          g->degree, g->pinned, g->pin_value, g->coeffs,
+                          &worst) != POLYFIT_SUCCESS ||
+      !(worst <= g->max_residual)) {
+    return false;
   }
 
-  for (int32_t i = 0; i < rows; i++) {
-    (*matrix)[i] = (float*)calloc(cols, sizeof(float));
-    if ((*matrix)[i] == NULL) {
-      // Clean up previously allocated rows
-      for (int32_t j = 0; j < i; j++) {
-        free((*matrix)[j]);
-      }
-      free(*matrix);
-      *matrix = NULL;
-      return POLYFIT_ERROR_MEMORY_ALLOC;
+  if (g->continuous && end < g->num_points) {
+    // At the knot t = 1, so the polynomial is the sum of its coefficients
+    float at_knot = 0.0f;
+    for (int32_t k = 0; k <= g->degree; k++) {
+      at_knot += g->coeffs[k];
     }
+    return polyfit_fabs(at_knot - g->y[end]) <= g->max_residual;
   }
 
-  return POLYFIT_SUCCESS;
+  return true;
 }
 
-static void free_matrix(float** matrix, int32_t rows) {
-  if (matrix != NULL) {
-    for (int32_t i = 0; i < rows; i++) {
-      free(matrix[i]);
+static polyfit_error_t piecewise_fit_fixed(
+    const float* x, const float* y, int32_t num_points, int32_t degree,
+    const float* breakpoints, int32_t num_segments, bool continuous,
+    polyfit_piecewise_t** out) {
+  if (x == NULL || y == NULL || breakpoints == NULL) {
+    return POLYFIT_ERROR_NULL_POINTER;
+  }
+
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_segments <= 0 || num_points <= 0) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  // Strictly ascending, which also rejects NaN knots
+  for (int32_t s = 0; s < num_segments; s++) {
+    if (!(breakpoints[s + 1] > breakpoints[s]) ||
+        !isfinite(breakpoints[s + 1] - breakpoints[s])) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+  }
+
+  polyfit_piecewise_t* pw = piecewise_create(num_segments, degree);
+  polyfit_moments_t* moments = (polyfit_moments_t*)polyfit_alloc_zeroed(
+      (size_t)num_segments, sizeof(polyfit_moments_t));
+  if (pw == NULL || moments == NULL) {
+    polyfit_piecewise_free(pw);
+    polyfit_dealloc(moments);
+    return POLYFIT_ERROR_MEMORY_ALLOC;
+  }
+
+  for (int32_t s = 0; s <= num_segments; s++) {
+    pw->breakpoints[s] = breakpoints[s];
+  }
+  for (int32_t s = 0; s < num_segments; s++) {
+    pw->inv_widths[s] = 1.0f / (breakpoints[s + 1] - breakpoints[s]);
+    moments_reset(&moments[s], degree);
+  }
+  piecewise_build_index(pw);
+
+  // The data may be in any order, so each point is routed to its segment
+  for (int32_t i = 0; i < num_points; i++) {
+    const int32_t s = piecewise_locate(pw, x[i]);
+    const float t = (x[i] - pw->breakpoints[s]) * pw->inv_widths[s];
+    update_moments(&moments[s], t, y[i], 1.0);
+    moments[s].num_points++;
+  }
+
+  polyfit_error_t error = POLYFIT_SUCCESS;
+  bool pinned = false;
+  float pin_value = 0.0f;
+  for (int32_t s = 0; s < num_segments && error == POLYFIT_SUCCESS; s++) {
+    const int64_t needed = pinned ? degree : (int64_t)degree + 1;
+    if (moments[s].num_points < needed) {
+      error = POLYFIT_ERROR_INSUFFICIENT_POINTS;
+      break;
     }
-    free(matrix);
+
+    error = validate_moments(&moments[s]);
+    if (error == POLYFIT_SUCCESS) {
+      float* coeffs = pw->coefficients + (size_t)s * (degree + 1);
+      error = piecewise_solve(&moments[s], degree, pinned, pin_value, coeffs);
+      pinned = continuous;
+      pin_value = piecewise_horner(pw, s, breakpoints[s + 1]);
+    }
+  }
+
+  polyfit_dealloc(moments);
+  if (error != POLYFIT_SUCCESS) {
+    polyfit_piecewise_free(pw);
+    return error;
   }
+
+  *out = pw;
+  return POLYFIT_SUCCESS;
 }
 
-static polyfit_error_t validate_input_arrays(const float* x, const float* y,
-                                             int32_t num_points) {
+static polyfit_error_t piecewise_fit_greedy(
+    const float* x, const float* y, int32_t num_points, int32_t degree,
+    float max_residual, int32_t max_segments, bool continuous,
+    polyfit_piecewise_t** out) {
   if (x == NULL || y == NULL) {
     return POLYFIT_ERROR_NULL_POINTER;
   }
 
-  if (num_points <= 0) {
+  if (degree < 0 || degree > POLYFIT_MAX_DEGREE) {
+    return POLYFIT_ERROR_INVALID_DEGREE;
+  }
+
+  if (num_points <= degree) {
+    return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+  }
+
+  if (!(max_residual >= 0.0f) || max_segments <= 0) {
     return POLYFIT_ERROR_INVALID_INPUT;
   }
 
-  // Check for NaN or infinite values
-  for (int32_t i = 0; i < num_points; i++) {
-    if (x[i] - x[i] != 0.0f || y[i] - y[i] != 0.0f) {  // NaN and Inf check
+  // Ascending (rejecting NaN) with a non-empty range
+  for (int32_t i = 1; i < num_points; i++) {
+    if (!(x[i] >= x[i - 1])) {
       return POLYFIT_ERROR_INVALID_INPUT;
     }
   }
+  if (!(x[num_points - 1] > x[0]) || !isfinite(x[num_points - 1] - x[0])) {
+    return POLYFIT_ERROR_INVALID_INPUT;
+  }
+
+  polyfit_piecewise_t* pw = piecewise_create(max_segments, degree);
+  if (pw == NULL) {
+    return POLYFIT_ERROR_MEMORY_ALLOC;
+  }
+
+  const int32_t min_len = degree + 1;
+  const float x_last = x[num_points - 1];
+  float trial[POLYFIT_MAX_DEGREE + 1];
+  piecewise_greedy_t greedy = {.x = x,
+                               .y = y,
+                               .num_points = num_points,
+                               .degree = degree,
+                               .max_residual = max_residual,
+                               .continuous = continuous,
+                               .pinned = false,
+                               .pin_value = 0.0f,
+                               .coeffs = trial};
+  polyfit_error_t error = POLYFIT_SUCCESS;
+  int32_t segment = 0;
+  int32_t start = 0;
+
+  while (start < num_points && error == POLYFIT_SUCCESS) {
+    const int32_t remaining = num_points - start;
+    const float left = x[start];
+
+    int32_t len = remaining;
+    if (segment < max_segments - 1 &&
+        !piecewise_candidate_fits(&greedy, start, remaining)) {
+      // Double while the target holds, then bisect the failing interval
+      int32_t good = min_len;
+      int32_t bad = remaining;
+      for (int64_t probe = 2 * (int64_t)min_len; probe < remaining;
+           probe *= 2) {
+        if (!piecewise_candidate_fits(&greedy, start, (int32_t)probe)) {
+          bad = (int32_t)probe;
+          break;
+        }
+        good = (int32_t)probe;
+      }
+      while (bad - good > 1) {
+        const int32_t mid = good + (bad - good) / 2;
+        if (piecewise_candidate_fits(&greedy, start, mid)) {
+          good = mid;
+        } else {
+          bad = mid;
+        }
+      }
+      len = good;
+
+      // Equal x values never straddle a knot, and a remainder too short
+      // (or too narrow) for a segment of its own joins this one
+      while (start + len < num_points &&
+             x[start + len] == x[start + len - 1]) {
+        len++;
+      }
+      if (remaining - len < min_len ||
+          (start + len < num_points && x[start + len] == x_last)) {
+        len = remaining;
+      }
+    }
+
+    const float right = (start + len < num_points) ? x[start + len] : x_last;
+    if (!(right > left)) {
+      error = POLYFIT_ERROR_INVALID_INPUT;
+      break;
+    }
 
+    float* coeffs = pw->coefficients + (size_t)segment * (degree + 1);
+    pw->breakpoints[segment] = left;
+    pw->inv_widths[segment] = 1.0f / (right - left);
+    error = piecewise_fit_range(x, y, start, len, left,
+                                pw->inv_widths[segment], degree,
+                                greedy.pinned, greedy.pin_value, coeffs, NULL);
+    greedy.pin_value = piecewise_horner(pw, segment, right);
+    greedy.pinned = continuous;
+    segment++;
+    start += len;
+  }
+
+  if (error != POLYFIT_SUCCESS) {
+    polyfit_piecewise_free(pw);
+    return error;
+  }
+
+  pw->num_segments = segment;
+  pw->breakpoints[segment] = x_last;
+  piecewise_build_index(pw);
+
+  *out = pw;
   return POLYFIT_SUCCESS;
 }
 
+#if defined(POLYFIT_ENABLE_STATS)
+static uint64_t stats_now_ns(void) {
+  struct timespec ts;
+  timespec_get(&ts, TIME_UTC);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void stats_record_accumulate(int32_t num_points, uint64_t start) {
+  const uint64_t elapsed = stats_now_ns() - start;
+  t_stats.points_processed += (uint64_t)num_points;
+  t_stats.accumulate_ns += elapsed;
+  t_pending_accumulate_ns += elapsed;
+}
+
+static void stats_record_solve(const polyfit_moments_t* moments,
+                               int32_t degree, polyfit_error_t error,
+                               uint64_t build_start, uint64_t solve_start) {
+  const uint64_t solve_end = stats_now_ns();
+
+  t_stats.fit_calls++;
+  t_stats.build_ns += solve_start - build_start;
+  t_stats.solve_ns += solve_end - solve_start;
+  if (error == POLYFIT_ERROR_SINGULAR_MATRIX) {
+    t_stats.singular_failures++;
+  }
+
+  if (g_stats_callback != NULL) {
+    polyfit_fit_event_t event;
+    event.degree = degree;
+    event.num_points = moments->num_points;
+    event.error = error;
+    event.pivot_ratio = t_stats.last_pivot_ratio;
+    event.accumulate_ns = t_pending_accumulate_ns;
+    event.build_ns = solve_start - build_start;
+    event.solve_ns = solve_end - solve_start;
+    g_stats_callback(&event, g_stats_user_data);
+  }
+  t_pending_accumulate_ns = 0;
+}
+#endif
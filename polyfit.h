@@ -37,6 +37,35 @@ extern "C" {
 /** @brief Maximum supported polynomial degree */
 #define POLYFIT_MAX_DEGREE (10)
 
+/**
+ * @brief Lowest degree that single-point evaluation runs with Estrin's scheme
+ *
+ * Below it the serial Horner chain is short enough to win; define before
+ * including polyfit.h when building the library to retune.
+ */
+#ifndef POLYFIT_ESTRIN_MIN_DEGREE
+#define POLYFIT_ESTRIN_MIN_DEGREE (4)
+#endif
+
+/** @brief Points per block when moments are accumulated in parallel mode */
+#define POLYFIT_PARALLEL_BLOCK_SIZE (65536)
+
+/** @brief Most threads a parallel accumulation uses; larger counts are clamped */
+#define POLYFIT_MAX_THREADS (64)
+
+/** @brief Alignment of polyfit_static_poly_t: one cache line, any SIMD load */
+#define POLYFIT_STATIC_ALIGNMENT (64)
+
+#ifdef __cplusplus
+#define POLYFIT_ALIGNAS(n) alignas(n)
+#else
+#define POLYFIT_ALIGNAS(n) _Alignas(n)
+#endif
+
+/** @brief Floats of buffer needed by a workspace for a given max degree */
+#define POLYFIT_WORKSPACE_FLOATS(max_degree) \
+  (((max_degree) + 1) * ((max_degree) + 1) + ((max_degree) + 1))
+
 /*============================================================================*/
 /* TYPE DEFINITIONS                                                           */
 /*============================================================================*/
@@ -56,13 +85,76 @@ typedef enum {
 
 /**
  * @brief Structure to represent a polynomial
+ *
+ * When is_normalized is set the coefficients describe p(t) with
+ * t = (x - x_offset) * x_scale, and every evaluation function applies that
+ * mapping to x first. A zero-initialised domain (is_normalized false) means
+ * the coefficients apply to x directly.
  */
 typedef struct {
   float* coefficients; /**< Array of polynomial coefficients */
   int32_t degree;      /**< Degree of the polynomial */
   bool is_valid;       /**< Flag indicating if polynomial is valid */
+  bool is_normalized;  /**< Coefficients are in the normalized domain t */
+  float x_offset;      /**< Subtracted from x when normalized */
+  float x_scale;       /**< Multiplies (x - x_offset) when normalized */
 } Polynomial;
 
+/**
+ * @brief Fixed-capacity polynomial with inline coefficients
+ *
+ * Value type with the same fields as Polynomial but room for
+ * POLYFIT_MAX_DEGREE + 1 coefficients in place, so it can live on the stack
+ * or inside another struct with no heap memory. The whole model fits in one
+ * 64-byte cache line. Zero-initialisation gives an invalid polynomial.
+ */
+typedef struct {
+  POLYFIT_ALIGNAS(POLYFIT_STATIC_ALIGNMENT)
+  float coefficients[POLYFIT_MAX_DEGREE + 1]; /**< Ascending coefficients */
+  int32_t degree;      /**< Degree of the polynomial */
+  bool is_valid;       /**< Flag indicating if polynomial is valid */
+  bool is_normalized;  /**< Coefficients are in the normalized domain t */
+  float x_offset;      /**< Subtracted from x when normalized */
+  float x_scale;       /**< Multiplies (x - x_offset) when normalized */
+} polyfit_static_poly_t;
+
+/**
+ * @brief Polynomial converted to integer arithmetic
+ *
+ * Input x is an int32 in Q input_frac_bits (value = x * 2^-input_frac_bits);
+ * 0 fractional bits takes raw ADC codes. Each Horner step k keeps its
+ * partial sum in an int32 whose Q format, frac_bits[k], is chosen from the
+ * largest value that sum can take over the conversion range, so no step can
+ * overflow and none wastes bits. Products use 64-bit intermediates. The
+ * result is in Q frac_bits[0].
+ */
+typedef struct {
+  int32_t coefficients[POLYFIT_MAX_DEGREE + 1]; /**< c_k in Q frac_bits[k] */
+  int32_t frac_bits[POLYFIT_MAX_DEGREE + 1];    /**< Q format of step k */
+  int32_t shifts[POLYFIT_MAX_DEGREE + 1]; /**< Right shift taking the step
+                                               k product to frac_bits[k] */
+  int32_t degree;          /**< Degree of the polynomial */
+  int32_t input_frac_bits; /**< Q format of x */
+  int32_t t_frac_bits;     /**< Q format of the evaluation variable t */
+  int32_t t_shift;         /**< Right shift that forms t */
+  int32_t x_min;           /**< Smallest input, Q input_frac_bits */
+  int32_t x_max;           /**< Largest input, Q input_frac_bits */
+  int64_t x_offset;        /**< Domain offset, Q input_frac_bits */
+  int32_t x_scale;         /**< Domain scale, Q scale_frac_bits */
+  int32_t scale_frac_bits; /**< Q format of x_scale */
+  bool is_normalized;      /**< t = (x - x_offset) * x_scale, else t = x */
+  float error_bound;       /**< Worst-case |result - p(x)| on the range */
+} polyfit_fixed_t;
+
+/**
+ * @brief Replacement for malloc/free used by every allocating function
+ */
+typedef struct {
+  void* (*alloc)(size_t size, void* user_data); /**< Returns NULL on failure */
+  void (*free)(void* ptr, void* user_data);     /**< Never given NULL */
+  void* user_data; /**< Passed through to both callbacks */
+} polyfit_allocator_t;
+
 /**
  * @brief Configuration structure for polynomial fitting
  */
@@ -70,8 +162,251 @@ typedef struct {
   float absolute_threshold; /**< Absolute threshold for near-zero values */
   float relative_threshold; /**< Relative threshold for near-zero values */
   bool enable_pivot_check; /**< Enable pivot checking in Gaussian elimination */
+  bool normalize_domain; /**< Fit against x mapped onto [-1, 1] */
+  int32_t num_threads; /**< Parallel mode thread count (0 = single pass),
+                            clamped to POLYFIT_MAX_THREADS */
+  const polyfit_allocator_t* allocator; /**< Per-call allocator, or NULL */
 } polyfit_config_t;
 
+/**
+ * @brief Element type of a typed input array
+ */
+typedef enum {
+  POLYFIT_TYPE_FLOAT = 0, /**< float */
+  POLYFIT_TYPE_DOUBLE,    /**< double */
+  POLYFIT_TYPE_INT16,     /**< int16_t, e.g. signed ADC samples */
+  POLYFIT_TYPE_UINT16,    /**< uint16_t, e.g. unsigned ADC samples */
+  POLYFIT_TYPE_INT32,     /**< int32_t */
+  POLYFIT_TYPE_INT64,     /**< int64_t, e.g. nanosecond timestamps */
+  POLYFIT_TYPE_INDEX      /**< No data; element i is the index i */
+} polyfit_type_t;
+
+/**
+ * @brief Typed view of an input array
+ *
+ * Element i is read as value = raw[i] * scale + offset, converted on the fly
+ * inside the accumulation loop, so no converted copy of the data is made.
+ * For POLYFIT_TYPE_INT64 the origin is first subtracted in integer
+ * arithmetic, value = (raw[i] - origin) * scale + offset, so large
+ * timestamps keep full precision. POLYFIT_TYPE_INDEX reads no memory:
+ * element i is i * scale + offset, an implicit evenly spaced axis.
+ *
+ * A non-zero stride is the distance in bytes between consecutive elements,
+ * so a field of an array of structs, or one half of an interleaved xy
+ * buffer, can be read in place. Build one with polyfit_input().
+ */
+typedef struct {
+  const void* data;    /**< First element */
+  polyfit_type_t type; /**< Element type */
+  double scale;        /**< Multiplies each element */
+  double offset;       /**< Added after scaling */
+  int64_t origin;      /**< Subtracted from int64 elements before scaling */
+  int32_t stride;      /**< Bytes between elements (0 = packed) */
+} polyfit_input_t;
+
+/**
+ * @brief Power and cross moments of a data set
+ *
+ * These are the sufficient statistics of a least squares fit. For a fit of
+ * degree d the normal matrix is Hankel-structured, A[i][j] = power_sums[i+j],
+ * and the right-hand side is B[i] = cross_sums[i]. Sums are accumulated in
+ * double because float sums lose precision well before a million points.
+ */
+typedef struct {
+  double power_sums[2 * POLYFIT_MAX_DEGREE + 1]; /**< Sum of x^k, k = 0..2d */
+  double cross_sums[POLYFIT_MAX_DEGREE + 1];     /**< Sum of x^k*y, k = 0..d */
+  double sum_y2;                                 /**< Sum of y^2 */
+  int32_t degree;     /**< Highest fit degree the moments support */
+  int64_t num_points; /**< Number of accumulated data points */
+} polyfit_moments_t;
+
+/**
+ * @brief Goodness-of-fit summary of a least squares fit
+ *
+ * Every field follows from the moments and the coefficients, so it costs no
+ * extra pass over the data. Sums of squares of weighted moments are
+ * weighted; k = degree + 1 is the number of fitted parameters.
+ */
+typedef struct {
+  double rss;               /**< Residual sum of squares */
+  double tss;               /**< Total sum of squares about the mean of y */
+  float r_squared;          /**< 1 - RSS/TSS */
+  float adj_r_squared;      /**< 1 - (1 - R²)(n - 1)/(n - k) */
+  float residual_std_error; /**< sqrt(RSS / (n - k)) */
+  float aic;                /**< n ln(RSS/n) + 2k */
+  float bic;                /**< n ln(RSS/n) + k ln(n) */
+  int64_t num_points;       /**< Number of data points n */
+  int64_t dof;              /**< Residual degrees of freedom n - k */
+} polyfit_quality_t;
+
+/**
+ * @brief Scratch memory for fitting without heap allocation
+ *
+ * Holds the normal matrix (flat, row-major, (max_degree + 1)^2 floats), its
+ * right-hand side and the moments of one fit. A workspace is created once
+ * and reused by every *_ws fit; it is not safe to share between threads.
+ */
+typedef struct {
+  float* matrix;     /**< Normal matrix, row-major */
+  float* rhs;        /**< Right-hand side of the normal equations */
+  polyfit_moments_t moments; /**< Moments of the current fit */
+  int32_t max_degree;        /**< Highest degree the workspace can solve */
+  bool owns_memory;          /**< Buffer was allocated by create */
+  polyfit_allocator_t allocator; /**< Allocator that owns the buffer */
+} polyfit_workspace_t;
+
+/**
+ * @brief Per-thread instrumentation counters
+ *
+ * Collected only when the library is built with POLYFIT_ENABLE_STATS. In
+ * other builds every instrumentation point compiles away and snapshots are
+ * zero with enabled == false. Counters belong to the thread that did the
+ * work; a parallel accumulation is counted on the calling thread.
+ */
+typedef struct {
+  uint64_t fit_calls;         /**< Normal-equation solves */
+  uint64_t points_processed;  /**< Points accumulated into moments */
+  uint64_t allocations;       /**< Allocations made through an allocator */
+  uint64_t singular_failures; /**< Solves rejected as singular */
+  uint64_t accumulate_ns;     /**< Time spent accumulating moments */
+  uint64_t build_ns;          /**< Time spent building normal matrices */
+  uint64_t solve_ns;          /**< Time spent in Gaussian elimination */
+  float last_pivot_ratio;     /**< min/max |pivot| of the last elimination */
+  bool enabled;               /**< Library was built with stats */
+} polyfit_stats_t;
+
+/**
+ * @brief Measurements of a single solve, passed to the stats callback
+ */
+typedef struct {
+  int32_t degree;         /**< Degree solved for */
+  int64_t num_points;     /**< Points in the moments */
+  polyfit_error_t error;  /**< Result of the solve */
+  float pivot_ratio;      /**< min/max |pivot|; near 0 is ill-conditioned */
+  uint64_t accumulate_ns; /**< Accumulation on this thread since last solve */
+  uint64_t build_ns;      /**< Time building the normal matrix */
+  uint64_t solve_ns;      /**< Time in Gaussian elimination */
+} polyfit_fit_event_t;
+
+/**
+ * @brief Callback invoked after every solve when stats are enabled
+ */
+typedef void (*polyfit_stats_callback_t)(const polyfit_fit_event_t* event,
+                                         void* user_data);
+
+/**
+ * @brief Incremental least squares fit state
+ *
+ * Holds the moments of every point added so far. Points can be added or
+ * removed in O(degree) each; the O(degree^3) solve only runs when coefficients
+ * are requested after the moments have changed. Requires no heap memory.
+ */
+typedef struct {
+  polyfit_moments_t moments;                  /**< Accumulated moments */
+  float coefficients[POLYFIT_MAX_DEGREE + 1]; /**< Cached fit coefficients */
+  bool is_dirty; /**< Moments changed since the cached fit was solved */
+} polyfit_accumulator_t;
+
+/**
+ * @brief Sliding-window fit over the most recent samples of a stream
+ *
+ * Samples are kept in a ring buffer. Each push adds the incoming point to the
+ * moments and subtracts the outgoing one, so an update costs O(degree). x is
+ * stored in the moments relative to x_origin; once per full window turnover
+ * the origin is moved to the middle of the window and the moments are rebuilt
+ * from the ring, which bounds the drift of the add/subtract updates.
+ */
+typedef struct {
+  float* x_values;      /**< Ring buffer of x values (capacity entries) */
+  float* y_values;      /**< Ring buffer of y values (capacity entries) */
+  int32_t capacity;     /**< Window length */
+  int32_t count;        /**< Number of samples currently in the window */
+  int32_t head;         /**< Ring index of the oldest sample */
+  int32_t since_rebuild; /**< Pushes since the moments were last rebuilt */
+  float x_origin;       /**< Offset subtracted from x before accumulation */
+  polyfit_accumulator_t acc; /**< Moments of the shifted window samples */
+} polyfit_window_t;
+
+/**
+ * @brief Many polynomials packed for vectorised evaluation
+ *
+ * Coefficients are stored degree-major (structure of arrays): coefficient k
+ * of model m lives at coefficients[k * stride + m]. Models of lower degree
+ * are zero-padded up to max_degree, so one Horner loop serves every model and
+ * each step reads a contiguous run of coefficients across models. Each model
+ * keeps its own normalization, with offset 0 and scale 1 for raw models.
+ */
+typedef struct {
+  float* coefficients; /**< (max_degree+1) rows of stride coefficients */
+  float* x_offsets;    /**< Per-model domain offset (stride entries) */
+  float* x_scales;     /**< Per-model domain scale (stride entries) */
+  int32_t num_models;  /**< Number of polynomials in the bank */
+  int32_t max_degree;  /**< Highest degree any model may have */
+  int32_t stride;      /**< Row length, num_models rounded up to 16 */
+} polyfit_bank_t;
+
+/**
+ * @brief Piecewise polynomial over ascending breakpoints
+ *
+ * Segment s covers [breakpoints[s], breakpoints[s + 1]) and is evaluated at
+ * the local coordinate t = (x - breakpoints[s]) * inv_widths[s], which runs
+ * from 0 to 1 across the segment. Coefficients are stored contiguously,
+ * segment-major: coefficient k of segment s lives at
+ * coefficients[s * (degree + 1) + k]. Points left of the first or right of
+ * the last breakpoint are extrapolated from the end segments.
+ *
+ * buckets is a uniform index over [breakpoints[0], breakpoints[num_segments]]:
+ * bucket b holds the segments buckets[b] to buckets[b + 1], so a lookup is
+ * one multiply plus a short branchless search.
+ */
+typedef struct {
+  float* coefficients; /**< num_segments rows of degree + 1 coefficients */
+  float* breakpoints;  /**< num_segments + 1 ascending knots */
+  float* inv_widths;   /**< 1 / width of each segment */
+  int32_t* buckets;    /**< First segment of each bucket (num_buckets + 1) */
+  float bucket_scale;  /**< num_buckets / total breakpoint range */
+  int32_t num_buckets; /**< Number of uniform buckets */
+  int32_t num_segments; /**< Number of polynomial pieces */
+  int32_t degree;       /**< Degree of every piece */
+} polyfit_piecewise_t;
+
+/**
+ * @brief Precomputed least squares solution for a fixed x grid
+ *
+ * For a fixed x the fitted coefficients are a linear function of y,
+ * c = (V^T V)^-1 V^T y, where V is the Vandermonde matrix of
+ * t = (x - x_offset) * x_scale, which maps the grid onto [-1, 1]. The plan
+ * stores that projection so each new y series is fitted by a matrix-vector
+ * product: no normal equations, no elimination and no allocation.
+ */
+typedef struct {
+  float* projection;  /**< (degree+1) x num_points row-major projection */
+  int32_t num_points; /**< Length of the x grid */
+  int32_t degree;     /**< Degree of the fitted polynomials */
+  float x_offset;     /**< Subtracted from x to form t */
+  float x_scale;      /**< Multiplies (x - x_offset) */
+} polyfit_plan_t;
+
+/**
+ * @brief Least squares fit in a basis of discrete orthogonal polynomials
+ *
+ * The basis is built over the data by the three-term (Forsythe) recurrence
+ *   p_0 = 1, p_-1 = 0, p_{k+1}(t) = (t - alpha[k]) p_k(t) - beta[k] p_{k-1}(t)
+ * with t = (x - x_offset) * x_scale mapping the data onto [-1, 1]. Because
+ * the basis is orthogonal over the data, each coefficient is an independent
+ * projection, and truncating to any lower degree gives that degree's least
+ * squares fit.
+ */
+typedef struct {
+  float alpha[POLYFIT_MAX_DEGREE + 1];        /**< Recurrence shifts */
+  float beta[POLYFIT_MAX_DEGREE + 1];         /**< Recurrence weights */
+  float coefficients[POLYFIT_MAX_DEGREE + 1]; /**< Orthogonal-basis weights */
+  float rss[POLYFIT_MAX_DEGREE + 1]; /**< Residual sum of squares per degree */
+  int32_t degree;                    /**< Highest fitted degree */
+  float x_offset;                    /**< Subtracted from x to form t */
+  float x_scale;                     /**< Multiplies (x - x_offset) */
+} polyfit_orthogonal_t;
+
 /*============================================================================*/
 /* FUNCTION DECLARATIONS                                                      */
 /*============================================================================*/
@@ -105,16 +440,251 @@ polyfit_error_t polyfit_least_squares(const float* x, const float* y,
                                       int32_t num_points, int32_t degree,
                                       Polynomial* result_poly);
 
+/**
+ * @brief Get the default fitting configuration
+ * @return Configuration with default thresholds and no domain normalization
+ */
+polyfit_config_t polyfit_default_config(void);
+
+/**
+ * @brief Perform least squares polynomial regression with a configuration
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (must be >= 0)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL)
+ * @return Error code indicating success or failure
+ * @note With config->normalize_domain the x range is mapped onto [-1, 1]
+ * before the moments are formed, which keeps high-degree fits of large x
+ * (timestamps, ADC codes) well inside float range. The mapping is stored in
+ * result_poly and applied by every evaluation function.
+ * @note With config->num_threads > 0 the moments are accumulated as by
+ * polyfit_compute_moments_parallel(), whose per-block moments are allocated
+ * through config->allocator.
+ */
+polyfit_error_t polyfit_least_squares_ex(const float* x, const float* y,
+                                         int32_t num_points, int32_t degree,
+                                         const polyfit_config_t* config,
+                                         Polynomial* result_poly);
+
+/**
+ * @brief Compute the moments of a data set in a single pass
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > 0)
+ * @param degree Highest fit degree the moments must support (0 to
+ * POLYFIT_MAX_DEGREE)
+ * @param moments Pointer to store the moments (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Each point is visited once; powers of x are formed by running
+ * products, so no call to polyfit_pow() is made.
+ */
+polyfit_error_t polyfit_compute_moments(const float* x, const float* y,
+                                        int32_t num_points, int32_t degree,
+                                        polyfit_moments_t* moments);
+
+/**
+ * @brief Compute the moments of a data set using several threads
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > 0)
+ * @param degree Highest fit degree the moments must support (0 to
+ * POLYFIT_MAX_DEGREE)
+ * @param num_threads Number of threads to use (must be > 0; clamped to
+ * POLYFIT_MAX_THREADS and to the number of blocks)
+ * @param moments Pointer to store the moments (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note The data is split into fixed blocks of POLYFIT_PARALLEL_BLOCK_SIZE
+ * points whose moments are reduced in a fixed pairwise tree, so the result is
+ * bit-identical for every num_threads. It may differ in the last bits from
+ * polyfit_compute_moments(). Threads are only available when the library is
+ * built with POLYFIT_ENABLE_THREADS; otherwise the blocks run on the calling
+ * thread with the same result.
+ */
+polyfit_error_t polyfit_compute_moments_parallel(const float* x,
+                                                 const float* y,
+                                                 int32_t num_points,
+                                                 int32_t degree,
+                                                 int32_t num_threads,
+                                                 polyfit_moments_t* moments);
+
+/**
+ * @brief Describe a typed input array
+ * @param data First element (must not be NULL when used)
+ * @param type Element type
+ * @return Input with scale 1 and offset 0; an int64 input takes its first
+ * element as origin
+ * @note Set scale/offset afterwards to convert, e.g., ADC codes to volts.
+ * Fits of an int64 x axis are in terms of x - origin.
+ */
+polyfit_input_t polyfit_input(const void* data, polyfit_type_t type);
+
+/**
+ * @brief Describe an implicit x axis x[i] = x0 + i * dx
+ * @param x0 Value of the first element
+ * @param dx Spacing between elements
+ * @return Input of type POLYFIT_TYPE_INDEX
+ */
+polyfit_input_t polyfit_input_index(double x0, double dx);
+
+/**
+ * @brief Compute the moments of typed input arrays in a single pass
+ * @param x Typed x values (must not be NULL)
+ * @param y Typed y values (must not be NULL)
+ * @param num_points Number of data points (must be > 0)
+ * @param degree Highest fit degree the moments must support (0 to
+ * POLYFIT_MAX_DEGREE)
+ * @param moments Pointer to store the moments (must not be NULL)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_compute_moments_typed(const polyfit_input_t* x,
+                                              const polyfit_input_t* y,
+                                              int32_t num_points,
+                                              int32_t degree,
+                                              polyfit_moments_t* moments);
+
+/**
+ * @brief Least squares regression on typed input arrays
+ * @param x Typed x values (must not be NULL)
+ * @param y Typed y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (must be >= 0)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL)
+ * @return Error code indicating success or failure
+ * @note Behaves like polyfit_least_squares_ex() on the converted values.
+ */
+polyfit_error_t polyfit_least_squares_typed(const polyfit_input_t* x,
+                                            const polyfit_input_t* y,
+                                            int32_t num_points,
+                                            int32_t degree,
+                                            const polyfit_config_t* config,
+                                            Polynomial* result_poly);
+
+/**
+ * @brief Compute the moments of a weighted data set in a single pass
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param w Array of non-negative weights (must not be NULL)
+ * @param num_points Number of data points (must be > 0)
+ * @param degree Highest fit degree the moments must support (0 to
+ * POLYFIT_MAX_DEGREE)
+ * @param moments Pointer to store the moments (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Every sum is weighted, so power_sums[0] is the total weight while
+ * num_points still counts the points. A weight of k gives the same moments
+ * as repeating the point k times; fractional weights are allowed. A
+ * negative or non-finite weight gives POLYFIT_ERROR_INVALID_INPUT.
+ */
+polyfit_error_t polyfit_compute_moments_weighted(const float* x,
+                                                 const float* y,
+                                                 const float* w,
+                                                 int32_t num_points,
+                                                 int32_t degree,
+                                                 polyfit_moments_t* moments);
+
+/**
+ * @brief Weighted least squares polynomial regression
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param w Array of non-negative weights (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (must be >= 0)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL)
+ * @return Error code indicating success or failure
+ * @note Minimises sum(w[i] * (p(x[i]) - y[i])^2) in the same single pass as
+ * the unweighted fit.
+ */
+polyfit_error_t polyfit_least_squares_weighted(const float* x, const float* y,
+                                               const float* w,
+                                               int32_t num_points,
+                                               int32_t degree,
+                                               const polyfit_config_t* config,
+                                               Polynomial* result_poly);
+
+/**
+ * @brief Add the moments of one data set into those of another
+ * @param dst Moments to update (must not be NULL)
+ * @param src Moments to add (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Both must have the same degree. Merging the moments of consecutive
+ * chunks gives the moments of the whole data set, so large inputs can be
+ * streamed chunk by chunk.
+ */
+polyfit_error_t polyfit_moments_merge(polyfit_moments_t* dst,
+                                      const polyfit_moments_t* src);
+
+/**
+ * @brief Solve the normal equations built from precomputed moments
+ * @param moments Pointer to the moments (must not be NULL)
+ * @param degree Degree of the polynomial (0 to moments->degree)
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL)
+ * @return Error code indicating success or failure
+ * @note A single set of moments can be solved for any degree up to the one it
+ * was computed for, without touching the data again.
+ */
+polyfit_error_t polyfit_fit_moments(const polyfit_moments_t* moments,
+                                    int32_t degree, Polynomial* result_poly);
+
 /**
  * @brief Evaluate a polynomial at a given x value
  * @param poly Pointer to the Polynomial structure (must not be NULL)
  * @param x Value at which to evaluate the polynomial
  * @param result Pointer to store the evaluation result (must not be NULL)
  * @return Error code indicating success or failure
+ * @note Degrees from POLYFIT_ESTRIN_MIN_DEGREE use polyfit_evaluate_estrin(),
+ * lower degrees polyfit_evaluate_horner().
  */
 polyfit_error_t polyfit_evaluate(const Polynomial* poly, float x,
                                  float* result);
 
+/**
+ * @brief Evaluate a polynomial with Horner's method
+ * @param poly Pointer to the Polynomial structure (must not be NULL)
+ * @param x Value at which to evaluate the polynomial
+ * @param result Pointer to store the evaluation result (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note The fewest operations, but each multiply-add waits for the previous
+ * one, so latency grows with the full degree.
+ */
+polyfit_error_t polyfit_evaluate_horner(const Polynomial* poly, float x,
+                                        float* result);
+
+/**
+ * @brief Evaluate a polynomial with Estrin's scheme
+ * @param poly Pointer to the Polynomial structure (must not be NULL)
+ * @param x Value at which to evaluate the polynomial
+ * @param result Pointer to store the evaluation result (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Pairs coefficients as c[2i] + c[2i+1] t, then combines the pairs with
+ * t^2, t^4, ... in a tree. The multiply-adds within a level are independent,
+ * so latency grows with log2(degree). Uses a fused multiply-add when the
+ * target has one in hardware.
+ */
+polyfit_error_t polyfit_evaluate_estrin(const Polynomial* poly, float x,
+                                        float* result);
+
+/**
+ * @brief Evaluate a polynomial at many x values
+ * @param poly Pointer to the Polynomial structure (must not be NULL)
+ * @param xs Array of x values (must not be NULL)
+ * @param out Array to store the results (must not be NULL, size >=
+ * num_points; may alias xs)
+ * @param num_points Number of values to evaluate (must be >= 0)
+ * @return Error code indicating success or failure
+ * @note The polynomial is validated once. Horner's method runs across 16, 8
+ * or 4 lanes when compiled with AVX-512, AVX2 or SSE2 respectively, with a
+ * scalar loop for the remainder.
+ */
+polyfit_error_t polyfit_evaluate_batch(const Polynomial* poly, const float* xs,
+                                       float* out, int32_t num_points);
+
 /**
  * @brief Get the maximum absolute magnitude among polynomial coefficients
  * @param poly Pointer to the Polynomial structure (must not be NULL)
@@ -125,6 +695,15 @@ polyfit_error_t polyfit_evaluate(const Polynomial* poly, float x,
 polyfit_error_t polyfit_get_max_coefficient_magnitude(const Polynomial* poly,
                                                       float* max_magnitude);
 
+/**
+ * @brief Rewrite a normalized polynomial in terms of raw x
+ * @param poly Pointer to the Polynomial structure (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Does nothing if the polynomial is not normalized. The raw-x
+ * coefficients can be far less well conditioned than the normalized ones.
+ */
+polyfit_error_t polyfit_denormalize(Polynomial* poly);
+
 /**
  * @brief Validate a polynomial structure
  * @param poly Pointer to the Polynomial structure
@@ -176,7 +755,7 @@ Polynomial* polyfit(const float* x, const float* y, int32_t num_points,
  * @param result Pointer to store the evaluation result (must not be NULL)
  * @return Error code indicating success or failure
  * @note This is a convenience function that doesn't require manual memory
- * management
+ * management; the fit lives on the stack and no heap memory is used
  *
  * @example
  * float x[] = {1, 2, 3, 4, 5};
@@ -198,7 +777,8 @@ polyfit_error_t polyfit_eval_at(const float* x, const float* y,
  * @param size Size of the coeffs array
  * @return Error code indicating success or failure
  * @note Coefficients are in ascending order: coeffs[0] + coeffs[1]*x +
- * coeffs[2]*x^2 + ...
+ * coeffs[2]*x^2 + ... For a normalized polynomial they apply to
+ * t = (x - x_offset) * x_scale; see polyfit_denormalize().
  *
  * @example
  * float coeffs[3];
@@ -214,6 +794,55 @@ polyfit_error_t polyfit_get_coefficients(const Polynomial* poly, float* coeffs,
 /* FIT QUALITY AND AUTO-DEGREE FUNCTIONS                                     */
 /*============================================================================*/
 
+/**
+ * @brief Residual sum of squares of a polynomial, computed from moments
+ * @param moments Pointer to the moments of the data (must not be NULL)
+ * @param poly Raw (not normalized) polynomial of degree <= moments->degree
+ * @param rss Output pointer for the residual sum of squares (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Uses RSS = sum(y^2) - 2 c^T b + c^T A c, which holds for any c, so no
+ * pass over the data is needed.
+ */
+polyfit_error_t polyfit_moments_rss(const polyfit_moments_t* moments,
+                                    const Polynomial* poly, double* rss);
+
+/**
+ * @brief Fit quality statistics of a polynomial, computed from moments
+ * @param moments Pointer to the moments of the data (must not be NULL)
+ * @param poly Raw (not normalized) polynomial of degree <= moments->degree
+ * @param quality Output statistics (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note RSS is formed as in polyfit_moments_rss(), so it is clamped at zero
+ * and loses relative precision once it falls far below sum(y^2). AIC and BIC
+ * floor RSS at float precision of y, as polyfit_best_degree() does. With no
+ * residual degrees of freedom the standard error is 0 and adjusted R² equals
+ * R².
+ */
+polyfit_error_t polyfit_moments_quality(const polyfit_moments_t* moments,
+                                        const Polynomial* poly,
+                                        polyfit_quality_t* quality);
+
+/**
+ * @brief Fit a polynomial and report its quality in a single data pass
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of polynomial to fit (0 to POLYFIT_MAX_DEGREE)
+ * @param config Configuration parameters (NULL for defaults)
+ * @param result_poly Pointer to store the fitted polynomial (must not be NULL)
+ * @param quality Output statistics (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Replaces polyfit_least_squares_ex() followed by polyfit_r_squared(),
+ * which reads the data three times. With normalize_domain the statistics are
+ * computed in the normalized domain, which leaves them unchanged.
+ */
+polyfit_error_t polyfit_least_squares_quality(const float* x, const float* y,
+                                              int32_t num_points,
+                                              int32_t degree,
+                                              const polyfit_config_t* config,
+                                              Polynomial* result_poly,
+                                              polyfit_quality_t* quality);
+
 /**
  * @brief Compute residuals between polynomial predictions and actual values
  * @param poly Pointer to fitted Polynomial (must not be NULL)
@@ -228,6 +857,21 @@ polyfit_error_t polyfit_compute_residuals(const Polynomial* poly,
                                           int32_t num_points,
                                           float* residuals);
 
+/**
+ * @brief Compute residuals from typed, strided or implicit inputs
+ * @param poly Pointer to fitted Polynomial (must not be NULL)
+ * @param x Typed x values (must not be NULL)
+ * @param y Typed y values (must not be NULL)
+ * @param num_points Number of data points
+ * @param residuals Output array of size >= num_points; stores (y_hat[i] - y[i])
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_compute_residuals_typed(const Polynomial* poly,
+                                                const polyfit_input_t* x,
+                                                const polyfit_input_t* y,
+                                                int32_t num_points,
+                                                float* residuals);
+
 /**
  * @brief Compute R-squared goodness-of-fit metric
  * @param poly Pointer to fitted Polynomial (must not be NULL)
@@ -241,6 +885,57 @@ polyfit_error_t polyfit_r_squared(const Polynomial* poly, const float* x,
                                   const float* y, int32_t num_points,
                                   float* r_squared);
 
+/**
+ * @brief Compute R-squared from typed, strided or implicit inputs
+ * @param poly Pointer to fitted Polynomial (must not be NULL)
+ * @param x Typed x values (must not be NULL)
+ * @param y Typed y values (must not be NULL)
+ * @param num_points Number of data points
+ * @param r_squared Output pointer for R² value
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_r_squared_typed(const Polynomial* poly,
+                                        const polyfit_input_t* x,
+                                        const polyfit_input_t* y,
+                                        int32_t num_points,
+                                        float* r_squared);
+
+/**
+ * @brief Compute weighted residuals
+ * @param poly Pointer to fitted Polynomial (must not be NULL)
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of y values (must not be NULL)
+ * @param w Array of non-negative weights (must not be NULL)
+ * @param num_points Number of data points
+ * @param residuals Output array of size >= num_points; stores
+ * sqrt(w[i]) * (y_hat[i] - y[i]), whose squares sum to the weighted RSS
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_compute_residuals_weighted(const Polynomial* poly,
+                                                   const float* x,
+                                                   const float* y,
+                                                   const float* w,
+                                                   int32_t num_points,
+                                                   float* residuals);
+
+/**
+ * @brief Compute weighted R-squared
+ * @param poly Pointer to fitted Polynomial (must not be NULL)
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of y values (must not be NULL)
+ * @param w Array of non-negative weights with a positive sum (must not be
+ * NULL)
+ * @param num_points Number of data points
+ * @param r_squared Output pointer for R² value
+ * @return Error code indicating success or failure
+ * @note Both sums of squares are weighted and taken about the weighted mean
+ * of y.
+ */
+polyfit_error_t polyfit_r_squared_weighted(const Polynomial* poly,
+                                           const float* x, const float* y,
+                                           const float* w, int32_t num_points,
+                                           float* r_squared);
+
 /**
  * @brief Automatically select the best polynomial degree using BIC
  *
@@ -249,6 +944,8 @@ polyfit_error_t polyfit_r_squared(const Polynomial* poly, const float* x,
  *   BIC = n * ln(RSS/n) + (d+1) * ln(n)
  *
  * BIC penalises complexity, preventing overfitting without cross-validation.
+ * The data is read once to form moments; every candidate is then solved and
+ * scored from those (see polyfit_best_degree_moments()).
  *
  * @param x Array of x values (must not be NULL)
  * @param y Array of y values (must not be NULL)
@@ -271,6 +968,862 @@ Polynomial* polyfit_best_degree(const float* x, const float* y,
                                 int32_t num_points, int32_t max_degree,
                                 int32_t* best_degree, polyfit_error_t* error);
 
+/**
+ * @brief Automatically select the best degree of a weighted fit using BIC
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of y values (must not be NULL)
+ * @param w Array of non-negative weights (must not be NULL)
+ * @param num_points Number of data points (must be > max_degree)
+ * @param max_degree Maximum degree to evaluate (1 to POLYFIT_MAX_DEGREE)
+ * @param best_degree Output pointer for selected degree (must not be NULL)
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to the best-fit Polynomial, or NULL on failure
+ * @note As polyfit_best_degree() with RSS replaced by the weighted RSS.
+ * Caller is responsible for freeing with polyfit_free().
+ */
+Polynomial* polyfit_best_degree_weighted(const float* x, const float* y,
+                                         const float* w, int32_t num_points,
+                                         int32_t max_degree,
+                                         int32_t* best_degree,
+                                         polyfit_error_t* error);
+
+/**
+ * @brief Select the best polynomial degree using BIC, from moments
+ * @param moments Pointer to the moments of the data (must not be NULL,
+ * moments->degree >= max_degree)
+ * @param max_degree Maximum degree to evaluate (1 to POLYFIT_MAX_DEGREE)
+ * @param patience Stop after this many consecutive degrees without a BIC
+ * improvement (0 to always try every degree)
+ * @param best_degree Output pointer for selected degree (must not be NULL)
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to the best-fit Polynomial, or NULL on failure
+ * @note No data pass: each candidate costs one O(degree^3) solve.
+ * Caller is responsible for freeing with polyfit_free()
+ */
+Polynomial* polyfit_best_degree_moments(const polyfit_moments_t* moments,
+                                        int32_t max_degree, int32_t patience,
+                                        int32_t* best_degree,
+                                        polyfit_error_t* error);
+
+/*============================================================================*/
+/* INCREMENTAL FITTING FUNCTIONS                                              */
+/*============================================================================*/
+
+/**
+ * @brief Initialize an empty accumulator for a given fit degree
+ * @param acc Pointer to the accumulator (must not be NULL)
+ * @param degree Degree of the polynomial to fit (0 to POLYFIT_MAX_DEGREE)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_accumulator_init(polyfit_accumulator_t* acc,
+                                         int32_t degree);
+
+/**
+ * @brief Remove all points from an accumulator, keeping its degree
+ * @param acc Pointer to the accumulator (must not be NULL)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_accumulator_reset(polyfit_accumulator_t* acc);
+
+/**
+ * @brief Add a single data point to an accumulator in O(degree)
+ * @param acc Pointer to the accumulator (must not be NULL)
+ * @param x X value of the point (must be finite)
+ * @param y Y value of the point (must be finite)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_accumulator_add_point(polyfit_accumulator_t* acc,
+                                              float x, float y);
+
+/**
+ * @brief Add an array of data points to an accumulator
+ * @param acc Pointer to the accumulator (must not be NULL)
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > 0)
+ * @return Error code indicating success or failure
+ * @note If any value is non-finite no point is added.
+ */
+polyfit_error_t polyfit_accumulator_add_points(polyfit_accumulator_t* acc,
+                                               const float* x, const float* y,
+                                               int32_t num_points);
+
+/**
+ * @brief Remove a previously added data point in O(degree)
+ * @param acc Pointer to the accumulator (must not be NULL)
+ * @param x X value of the point, exactly as it was added
+ * @param y Y value of the point, exactly as it was added
+ * @return Error code indicating success or failure
+ * @note Removing a point that was never added silently corrupts the fit.
+ */
+polyfit_error_t polyfit_accumulator_remove_point(polyfit_accumulator_t* acc,
+                                                 float x, float y);
+
+/**
+ * @brief Get the fitted polynomial for the points currently accumulated
+ * @param acc Pointer to the accumulator (must not be NULL)
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL, capacity >= degree+1 coefficients)
+ * @return Error code indicating success or failure
+ * @note The normal equations are only solved if points were added or removed
+ * since the last call; otherwise the cached coefficients are copied.
+ *
+ * @example
+ * polyfit_accumulator_t acc;
+ * polyfit_accumulator_init(&acc, 2);
+ * for (;;) {
+ *     polyfit_accumulator_add_point(&acc, read_x(), read_y());
+ *     if (polyfit_accumulator_solve(&acc, poly) == POLYFIT_SUCCESS) {
+ *         ...
+ *     }
+ * }
+ */
+polyfit_error_t polyfit_accumulator_solve(polyfit_accumulator_t* acc,
+                                          Polynomial* result_poly);
+
+/*============================================================================*/
+/* SLIDING WINDOW FUNCTIONS                                                   */
+/*============================================================================*/
+
+/**
+ * @brief Create a sliding-window fitter
+ * @param capacity Number of most recent samples in the window (must be >
+ * degree)
+ * @param degree Degree of the polynomial (0 to POLYFIT_MAX_DEGREE)
+ * @return Pointer to the window, or NULL on failure
+ * @note This is the only allocation; pushing and solving use no heap memory.
+ * Caller is responsible for freeing with polyfit_window_free()
+ */
+polyfit_window_t* polyfit_window_create(int32_t capacity, int32_t degree);
+
+/**
+ * @brief Free a sliding-window fitter
+ * @param win Pointer to the window (may be NULL)
+ */
+void polyfit_window_free(polyfit_window_t* win);
+
+/**
+ * @brief Push a sample, evicting the oldest one once the window is full
+ * @param win Pointer to the window (must not be NULL)
+ * @param x X value of the sample (must be finite)
+ * @param y Y value of the sample (must be finite)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_window_push(polyfit_window_t* win, float x, float y);
+
+/**
+ * @brief Fit the samples currently in the window
+ * @param win Pointer to the window (must not be NULL)
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL, capacity >= degree+1 coefficients)
+ * @param newest_value Optional pointer to store the fitted value at the
+ * newest sample's x (can be NULL)
+ * @return Error code indicating success or failure
+ * @note result_poly is normalized with x_offset set to the window origin, so
+ * evaluating it stays accurate however large x grows.
+ */
+polyfit_error_t polyfit_window_solve(polyfit_window_t* win,
+                                     Polynomial* result_poly,
+                                     float* newest_value);
+
+/*============================================================================*/
+/* MODEL BANK FUNCTIONS                                                       */
+/*============================================================================*/
+
+/**
+ * @brief Create an empty bank (all coefficients zero)
+ * @param num_models Number of polynomials in the bank (must be > 0)
+ * @param max_degree Highest degree of any model (0 to POLYFIT_MAX_DEGREE)
+ * @return Pointer to the bank, or NULL on failure
+ * @note Caller is responsible for freeing with polyfit_bank_free()
+ */
+polyfit_bank_t* polyfit_bank_create(int32_t num_models, int32_t max_degree);
+
+/**
+ * @brief Create a bank holding copies of existing polynomials
+ * @param polys Array of num_models valid polynomials (must not be NULL)
+ * @param num_models Number of polynomials (must be > 0)
+ * @return Pointer to the bank, or NULL on failure
+ * @note max_degree is the highest degree among the inputs. Caller is
+ * responsible for freeing with polyfit_bank_free()
+ */
+polyfit_bank_t* polyfit_bank_create_from(const Polynomial* const* polys,
+                                         int32_t num_models);
+
+/**
+ * @brief Free a bank
+ * @param bank Pointer to the bank (may be NULL)
+ */
+void polyfit_bank_free(polyfit_bank_t* bank);
+
+/**
+ * @brief Copy a polynomial into a bank slot
+ * @param bank Pointer to the bank (must not be NULL)
+ * @param index Slot index (0 to num_models-1)
+ * @param poly Valid polynomial with degree <= bank->max_degree
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_bank_set(polyfit_bank_t* bank, int32_t index,
+                                 const Polynomial* poly);
+
+/**
+ * @brief Copy an ascending coefficient array into a bank slot
+ * @param bank Pointer to the bank (must not be NULL)
+ * @param index Slot index (0 to num_models-1)
+ * @param coeffs Coefficients as returned by polyfit_get_coefficients()
+ * @param degree Degree of the model (0 to bank->max_degree)
+ * @return Error code indicating success or failure
+ * @note The coefficients are taken to apply to raw x.
+ */
+polyfit_error_t polyfit_bank_set_coefficients(polyfit_bank_t* bank,
+                                              int32_t index,
+                                              const float* coeffs,
+                                              int32_t degree);
+
+/**
+ * @brief Evaluate every model at the same x
+ * @param bank Pointer to the bank (must not be NULL)
+ * @param x Value at which to evaluate all models
+ * @param out Array to store the results (must not be NULL, size >=
+ * num_models)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_bank_evaluate_shared(const polyfit_bank_t* bank,
+                                             float x, float* out);
+
+/**
+ * @brief Evaluate each model at its own x
+ * @param bank Pointer to the bank (must not be NULL)
+ * @param xs Array of num_models x values; model m is evaluated at xs[m]
+ * @param out Array to store the results (must not be NULL, size >=
+ * num_models; may alias xs)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_bank_evaluate_each(const polyfit_bank_t* bank,
+                                           const float* xs, float* out);
+
+/*============================================================================*/
+/* PIECEWISE POLYNOMIAL FUNCTIONS                                             */
+/*============================================================================*/
+
+/**
+ * @brief Fit a piecewise polynomial with fixed breakpoints
+ * @param x Array of x values, in any order (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points
+ * @param degree Degree of every segment (0 to POLYFIT_MAX_DEGREE)
+ * @param breakpoints num_segments + 1 strictly ascending knots (must not be
+ * NULL)
+ * @param num_segments Number of segments (must be > 0)
+ * @param continuous Pin each segment to the end value of the previous one
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to the fitted model, or NULL on failure
+ * @note Every segment needs degree + 1 points (degree when continuous).
+ * Continuity is imposed segment by segment from the left, so the pieces meet
+ * at every knot but the fit is not a global least squares spline. Points
+ * outside the knots belong to the end segments. Caller is responsible for
+ * freeing with polyfit_piecewise_free().
+ */
+polyfit_piecewise_t* polyfit_piecewise_fit(const float* x, const float* y,
+                                           int32_t num_points, int32_t degree,
+                                           const float* breakpoints,
+                                           int32_t num_segments,
+                                           bool continuous,
+                                           polyfit_error_t* error);
+
+/**
+ * @brief Fit a piecewise polynomial, choosing breakpoints for a target error
+ * @param x Array of ascending x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points
+ * @param degree Degree of every segment (0 to POLYFIT_MAX_DEGREE)
+ * @param max_residual Largest allowed |y_hat - y| within a segment (>= 0)
+ * @param max_segments Upper bound on the number of segments (must be > 0)
+ * @param continuous Pin each segment to the end value of the previous one
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to the fitted model, or NULL on failure
+ * @note Segments are grown greedily from the left, each as long as the
+ * target allows, found by doubling then bisecting its length. When
+ * max_segments is reached the last segment takes all remaining points and
+ * may exceed max_residual. Caller is responsible for freeing with
+ * polyfit_piecewise_free().
+ */
+polyfit_piecewise_t* polyfit_piecewise_fit_auto(const float* x, const float* y,
+                                                int32_t num_points,
+                                                int32_t degree,
+                                                float max_residual,
+                                                int32_t max_segments,
+                                                bool continuous,
+                                                polyfit_error_t* error);
+
+/**
+ * @brief Free a piecewise polynomial
+ * @param pw Pointer to the model (can be NULL)
+ */
+void polyfit_piecewise_free(polyfit_piecewise_t* pw);
+
+/**
+ * @brief Find the segment that evaluates x
+ * @param pw Pointer to the model (must not be NULL)
+ * @param x Point to locate
+ * @return Segment index (0 to num_segments - 1)
+ * @note Uses the bucket index and a branchless search within the bucket.
+ */
+int32_t polyfit_piecewise_segment(const polyfit_piecewise_t* pw, float x);
+
+/**
+ * @brief Evaluate a piecewise polynomial at a single point
+ * @param pw Pointer to the model (must not be NULL)
+ * @param x Point at which to evaluate
+ * @param result Pointer to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_piecewise_evaluate(const polyfit_piecewise_t* pw,
+                                           float x, float* result);
+
+/**
+ * @brief Evaluate a piecewise polynomial at many points in any order
+ * @param pw Pointer to the model (must not be NULL)
+ * @param xs Array of evaluation points (must not be NULL)
+ * @param out Array to store the results (must not be NULL)
+ * @param num_points Number of points
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_piecewise_evaluate_batch(const polyfit_piecewise_t* pw,
+                                                 const float* xs, float* out,
+                                                 int32_t num_points);
+
+/**
+ * @brief Evaluate a piecewise polynomial at ascending points
+ * @param pw Pointer to the model (must not be NULL)
+ * @param xs Array of evaluation points, ascending (must not be NULL)
+ * @param out Array to store the results (must not be NULL)
+ * @param num_points Number of points
+ * @return Error code indicating success or failure
+ * @note Walks the segments forward instead of searching; a point that steps
+ * backwards falls back to a lookup, so any order is still correct.
+ */
+polyfit_error_t polyfit_piecewise_evaluate_sorted(
+    const polyfit_piecewise_t* pw, const float* xs, float* out,
+    int32_t num_points);
+
+/*============================================================================*/
+/* FIT PLAN FUNCTIONS                                                         */
+/*============================================================================*/
+
+/**
+ * @brief Create a fit plan for a fixed x grid
+ * @param x Array of x values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to POLYFIT_MAX_DEGREE)
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to the plan, or NULL on failure
+ * @note Costs O(num_points * degree^2) once. The projection is formed in
+ * double from a QR factorization of the normalized Vandermonde matrix, so
+ * wide grids stay well conditioned. Caller is responsible for freeing with
+ * polyfit_plan_free()
+ */
+polyfit_plan_t* polyfit_plan_create(const float* x, int32_t num_points,
+                                    int32_t degree, polyfit_error_t* error);
+
+/**
+ * @brief Free a fit plan
+ * @param plan Pointer to the plan (may be NULL)
+ */
+void polyfit_plan_free(polyfit_plan_t* plan);
+
+/**
+ * @brief Fit one y series on the plan's x grid
+ * @param plan Pointer to the plan (must not be NULL)
+ * @param y Array of plan->num_points y values (must not be NULL)
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL, capacity >= degree+1 coefficients)
+ * @return Error code indicating success or failure
+ * @note O(num_points * degree); gives the same fitted curve as
+ * polyfit_least_squares() up to rounding. The result is normalized with the
+ * plan's x_offset and x_scale.
+ */
+polyfit_error_t polyfit_plan_execute(const polyfit_plan_t* plan,
+                                     const float* y, Polynomial* result_poly);
+
+/**
+ * @brief Fit many y series on the plan's x grid in one pass
+ * @param plan Pointer to the plan (must not be NULL)
+ * @param ys Series stored one after another: series s starts at
+ * ys[s * plan->num_points] (must not be NULL)
+ * @param num_series Number of series (must be > 0)
+ * @param coeffs Output of num_series * (degree+1) coefficients in
+ * t = (x - plan->x_offset) * plan->x_scale; series s is written in ascending
+ * order at coeffs[s * (degree+1)] (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note The projection is applied in cache-sized blocks of points, each block
+ * reused across several series before moving on.
+ */
+polyfit_error_t polyfit_plan_execute_batch(const polyfit_plan_t* plan,
+                                           const float* ys, int32_t num_series,
+                                           float* coeffs);
+
+/*============================================================================*/
+/* ORTHOGONAL POLYNOMIAL FUNCTIONS                                            */
+/*============================================================================*/
+
+/**
+ * @brief Fit in a discrete orthogonal basis without a matrix solve
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to POLYFIT_MAX_DEGREE)
+ * @param result Pointer to store the fit (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note O(num_points * degree) with two passes per degree and three
+ * num_points-sized scratch arrays. result->rss[k] is the residual sum of
+ * squares of the degree-k fit, so a degree sweep costs nothing extra.
+ */
+polyfit_error_t polyfit_orthogonal_fit(const float* x, const float* y,
+                                       int32_t num_points, int32_t degree,
+                                       polyfit_orthogonal_t* result);
+
+/**
+ * @brief Evaluate an orthogonal-basis fit with Clenshaw's recurrence
+ * @param ortho Pointer to the fit (must not be NULL)
+ * @param x Value at which to evaluate
+ * @param result Pointer to store the evaluation result (must not be NULL)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_orthogonal_evaluate(const polyfit_orthogonal_t* ortho,
+                                            float x, float* result);
+
+/**
+ * @brief Convert an orthogonal-basis fit to a normalized Polynomial
+ * @param ortho Pointer to the fit (must not be NULL)
+ * @param degree Degree to keep (0 to ortho->degree); lower degrees give the
+ * least squares fit of that degree
+ * @param result_poly Pointer to store the resulting polynomial (must not be
+ * NULL, capacity >= degree+1 coefficients)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_orthogonal_to_polynomial(
+    const polyfit_orthogonal_t* ortho, int32_t degree, Polynomial* result_poly);
+
+/*============================================================================*/
+/* WORKSPACE AND ALLOCATOR FUNCTIONS                                          */
+/*============================================================================*/
+
+/**
+ * @brief Replace the allocator used by every allocating function
+ * @param allocator New allocator, copied (NULL restores malloc/free)
+ * @return Error code indicating success or failure
+ * @note Not thread safe; install the allocator before other threads use the
+ * library, and free objects with the allocator that created them.
+ */
+polyfit_error_t polyfit_set_allocator(const polyfit_allocator_t* allocator);
+
+/**
+ * @brief Create a workspace for fits up to a maximum degree
+ * @param max_degree Highest degree the workspace must solve (0 to
+ * POLYFIT_MAX_DEGREE)
+ * @param allocator Allocator for the buffer (NULL for the global allocator)
+ * @return Pointer to the workspace, or NULL on failure
+ */
+polyfit_workspace_t* polyfit_workspace_create(
+    int32_t max_degree, const polyfit_allocator_t* allocator);
+
+/**
+ * @brief Set up a workspace over caller-provided memory
+ * @param ws Workspace to initialise (must not be NULL)
+ * @param buffer Memory for the workspace (must not be NULL)
+ * @param buffer_len Number of floats in buffer (at least
+ * POLYFIT_WORKSPACE_FLOATS(max_degree))
+ * @param max_degree Highest degree the workspace must solve
+ * @return Error code indicating success or failure
+ * @note No allocation is made; ws must not be passed to
+ * polyfit_workspace_free().
+ */
+polyfit_error_t polyfit_workspace_init(polyfit_workspace_t* ws, float* buffer,
+                                       int32_t buffer_len, int32_t max_degree);
+
+/**
+ * @brief Free a workspace made by polyfit_workspace_create()
+ * @param ws Workspace to free (can be NULL)
+ */
+void polyfit_workspace_free(polyfit_workspace_t* ws);
+
+/**
+ * @brief Least squares fit using a workspace
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to ws->max_degree)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param ws Workspace (must not be NULL)
+ * @param result_poly Polynomial to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Behaves like polyfit_least_squares_ex(). With num_threads == 0 the
+ * call makes no heap allocation, and the moments stay in ws->moments for
+ * reuse (e.g. by polyfit_fit_moments_ws() at a lower degree).
+ */
+polyfit_error_t polyfit_least_squares_ws(const float* x, const float* y,
+                                         int32_t num_points, int32_t degree,
+                                         const polyfit_config_t* config,
+                                         polyfit_workspace_t* ws,
+                                         Polynomial* result_poly);
+
+/**
+ * @brief Weighted least squares fit using a workspace
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param w Array of non-negative weights (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to ws->max_degree)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param ws Workspace (must not be NULL)
+ * @param result_poly Polynomial to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Behaves like polyfit_least_squares_weighted(); the weighted moments
+ * stay in ws->moments.
+ */
+polyfit_error_t polyfit_least_squares_weighted_ws(
+    const float* x, const float* y, const float* w, int32_t num_points,
+    int32_t degree, const polyfit_config_t* config, polyfit_workspace_t* ws,
+    Polynomial* result_poly);
+
+/**
+ * @brief Least squares fit on typed input arrays using a workspace
+ * @param x Typed x values (must not be NULL)
+ * @param y Typed y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to ws->max_degree)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param ws Workspace (must not be NULL)
+ * @param result_poly Polynomial to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Behaves like polyfit_least_squares_typed().
+ */
+polyfit_error_t polyfit_least_squares_typed_ws(const polyfit_input_t* x,
+                                               const polyfit_input_t* y,
+                                               int32_t num_points,
+                                               int32_t degree,
+                                               const polyfit_config_t* config,
+                                               polyfit_workspace_t* ws,
+                                               Polynomial* result_poly);
+
+/**
+ * @brief Fit and report its quality in a single data pass using a workspace
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to ws->max_degree)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param ws Workspace (must not be NULL)
+ * @param result_poly Polynomial to store the result (must not be NULL)
+ * @param quality Output statistics (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Behaves like polyfit_least_squares_quality().
+ */
+polyfit_error_t polyfit_least_squares_quality_ws(
+    const float* x, const float* y, int32_t num_points, int32_t degree,
+    const polyfit_config_t* config, polyfit_workspace_t* ws,
+    Polynomial* result_poly, polyfit_quality_t* quality);
+
+/**
+ * @brief Solve precomputed moments using a workspace
+ * @param moments Moments from polyfit_compute_moments() (must not be NULL)
+ * @param degree Degree of the fit (0 to min(moments->degree, ws->max_degree))
+ * @param ws Workspace (must not be NULL)
+ * @param result_poly Polynomial to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_fit_moments_ws(const polyfit_moments_t* moments,
+                                       int32_t degree, polyfit_workspace_t* ws,
+                                       Polynomial* result_poly);
+
+/*============================================================================*/
+/* STATIC POLYNOMIAL FUNCTIONS                                                */
+/*============================================================================*/
+
+/**
+ * @brief Initialize a fixed-capacity polynomial to zero
+ * @param poly Polynomial to initialize (must not be NULL)
+ * @param degree Degree of the polynomial (0 to POLYFIT_MAX_DEGREE)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_static_init(polyfit_static_poly_t* poly,
+                                    int32_t degree);
+
+/**
+ * @brief Least squares fit into a fixed-capacity polynomial
+ * @param x Array of x values (must not be NULL)
+ * @param y Array of corresponding y values (must not be NULL)
+ * @param num_points Number of data points (must be > degree)
+ * @param degree Degree of the polynomial (0 to POLYFIT_MAX_DEGREE)
+ * @param config Fitting configuration (NULL for polyfit_default_config())
+ * @param result_poly Polynomial to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Same result as polyfit_least_squares_ex(); makes no heap allocation
+ * unless config->num_threads > 0.
+ */
+polyfit_error_t polyfit_static_fit(const float* x, const float* y,
+                                   int32_t num_points, int32_t degree,
+                                   const polyfit_config_t* config,
+                                   polyfit_static_poly_t* result_poly);
+
+/**
+ * @brief Evaluate a fixed-capacity polynomial at a given point
+ * @param poly Polynomial to evaluate (must not be NULL)
+ * @param x Point at which to evaluate
+ * @param result Pointer to store the result (must not be NULL)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_static_evaluate(const polyfit_static_poly_t* poly,
+                                        float x, float* result);
+
+/**
+ * @brief Evaluate a fixed-capacity polynomial at many points
+ * @param poly Polynomial to evaluate (must not be NULL)
+ * @param xs Array of evaluation points (must not be NULL)
+ * @param out Array to store the results (must not be NULL)
+ * @param num_points Number of points (must be >= 0)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_static_evaluate_batch(
+    const polyfit_static_poly_t* poly, const float* xs, float* out,
+    int32_t num_points);
+
+/**
+ * @brief Get the coefficients of a fixed-capacity polynomial
+ * @param poly Polynomial (must not be NULL)
+ * @param coeffs Array to store coefficients (must not be NULL)
+ * @param size Size of the coeffs array (must be >= degree+1)
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_static_get_coefficients(
+    const polyfit_static_poly_t* poly, float* coeffs, int32_t size);
+
+/**
+ * @brief Copy a Polynomial into a fixed-capacity polynomial
+ * @param dst Destination (must not be NULL)
+ * @param src Valid source polynomial
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_static_from_polynomial(polyfit_static_poly_t* dst,
+                                               const Polynomial* src);
+
+/**
+ * @brief View a fixed-capacity polynomial as a Polynomial
+ * @param poly Polynomial to view (must not be NULL)
+ * @return Polynomial whose coefficients point into poly
+ * @note The view copies the degree and domain, so it can be passed to any
+ * function taking a const Polynomial*. It must not outlive poly or be given
+ * to polyfit_free().
+ */
+Polynomial polyfit_static_view(polyfit_static_poly_t* poly);
+
+/*============================================================================*/
+/* FIXED-POINT FUNCTIONS                                                      */
+/*============================================================================*/
+
+/**
+ * @brief Convert a polynomial to fixed point for a given input range
+ * @param poly Valid polynomial (must not be NULL)
+ * @param x_min Smallest x the model will be evaluated at
+ * @param x_max Largest x (must be > x_min)
+ * @param input_frac_bits Fractional bits of the integer input (0 to 30)
+ * @param fixed Output model (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note The Q formats come from bounds on every Horner partial sum over
+ * [x_min, x_max]. fixed->error_bound is a worst-case bound, in real units,
+ * on the difference from exact evaluation of poly's float coefficients at
+ * the same x; it covers coefficient, domain and per-step rounding. Fails
+ * with POLYFIT_ERROR_INVALID_INPUT if the range or any partial sum cannot be
+ * represented in 32 bits.
+ */
+polyfit_error_t polyfit_fixed_from_polynomial(const Polynomial* poly,
+                                              float x_min, float x_max,
+                                              int32_t input_frac_bits,
+                                              polyfit_fixed_t* fixed);
+
+/**
+ * @brief Evaluate a fixed-point polynomial with integer Horner's method
+ * @param fixed Converted model (must not be NULL)
+ * @param x Input in Q fixed->input_frac_bits
+ * @return p(x) in Q fixed->frac_bits[0]
+ * @note Uses only integer multiplies and shifts. x is clamped to the
+ * conversion range, where error_bound holds.
+ */
+int32_t polyfit_fixed_evaluate(const polyfit_fixed_t* fixed, int32_t x);
+
+/**
+ * @brief Evaluate a fixed-point polynomial at many points
+ * @param fixed Converted model (must not be NULL)
+ * @param xs Inputs in Q fixed->input_frac_bits (must not be NULL)
+ * @param out Results in Q fixed->frac_bits[0] (must not be NULL)
+ * @param num_points Number of points
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_fixed_evaluate_batch(const polyfit_fixed_t* fixed,
+                                             const int32_t* xs, int32_t* out,
+                                             int32_t num_points);
+
+/*============================================================================*/
+/* INVERSE EVALUATION FUNCTIONS                                               */
+/*============================================================================*/
+
+/**
+ * @brief Solve p(x) = y for x in [lo, hi]
+ * @param poly Valid polynomial (must not be NULL)
+ * @param y Target value
+ * @param lo Lower end of the search interval
+ * @param hi Upper end of the search interval (must be > lo)
+ * @param x Output pointer for the solution (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Uses Newton's method with p and p' from one Horner pass, falling back
+ * to bisection whenever a step would leave the bracket or converge slowly, so
+ * it never diverges. p(lo) - y and p(hi) - y must differ in sign (or be zero),
+ * otherwise POLYFIT_ERROR_INVALID_INPUT is returned; if several roots lie in
+ * the interval, one of them is found.
+ */
+polyfit_error_t polyfit_inverse(const Polynomial* poly, float y, float lo,
+                                float hi, float* x);
+
+/**
+ * @brief Solve p(x) = ys[i] for many targets
+ * @param poly Valid polynomial (must not be NULL)
+ * @param ys Target values (must not be NULL)
+ * @param xs Output array of solutions (must not be NULL)
+ * @param num_points Number of targets
+ * @param lo Lower end of the search interval
+ * @param hi Upper end of the search interval (must be > lo)
+ * @return Error code indicating success or failure
+ * @note Each solve starts from the previous solution, so sorted targets on a
+ * monotonic curve typically converge in a couple of Newton steps. Targets
+ * not bracketed by [lo, hi] give NaN and the call returns
+ * POLYFIT_ERROR_INVALID_INPUT after solving the rest.
+ */
+polyfit_error_t polyfit_inverse_batch(const Polynomial* poly, const float* ys,
+                                      float* xs, int32_t num_points, float lo,
+                                      float hi);
+
+/**
+ * @brief Fit a polynomial approximating the inverse of poly over [lo, hi]
+ * @param poly Valid polynomial, strictly monotonic on [lo, hi] (must not be
+ * NULL)
+ * @param lo Lower end of the range
+ * @param hi Upper end of the range (must be > lo)
+ * @param degree Degree of the inverse (1 to POLYFIT_MAX_DEGREE)
+ * @param max_error Optional output for the largest |q(p(x)) - x| over the
+ * fitting samples (can be NULL)
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to the normalized inverse polynomial, or NULL on failure
+ * @note Lookups through the result cost one O(degree) evaluation instead of
+ * an iterative solve; check max_error against the accuracy you need, and
+ * raise the degree or narrow the range if it is too large. Caller is
+ * responsible for freeing with polyfit_free().
+ */
+Polynomial* polyfit_inverse_polynomial(const Polynomial* poly, float lo,
+                                       float hi, int32_t degree,
+                                       float* max_error,
+                                       polyfit_error_t* error);
+
+/*============================================================================*/
+/* CALCULUS FUNCTIONS                                                         */
+/*============================================================================*/
+
+/**
+ * @brief Create the derivative of a polynomial
+ * @param poly Valid polynomial (must not be NULL)
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to dp/dx of degree max(degree - 1, 0), or NULL on failure
+ * @note A normalized polynomial yields a normalized derivative on the same
+ * domain, with the chain-rule factor x_scale folded into its coefficients.
+ * Caller is responsible for freeing with polyfit_free().
+ */
+Polynomial* polyfit_derivative(const Polynomial* poly, polyfit_error_t* error);
+
+/**
+ * @brief Create an antiderivative of a polynomial
+ * @param poly Valid polynomial of degree < POLYFIT_MAX_DEGREE (must not be
+ * NULL)
+ * @param error Optional pointer to store error code (can be NULL)
+ * @return Pointer to an antiderivative of degree + 1, or NULL on failure
+ * @note The integration constant makes the result zero at x = 0, or at
+ * x = x_offset for a normalized polynomial, whose domain the result keeps.
+ * Caller is responsible for freeing with polyfit_free().
+ */
+Polynomial* polyfit_antiderivative(const Polynomial* poly,
+                                   polyfit_error_t* error);
+
+/**
+ * @brief Evaluate p(x), p'(x) and p''(x) in one Horner pass
+ * @param poly Valid polynomial (must not be NULL)
+ * @param x Point to evaluate at
+ * @param value Output for p(x) (must not be NULL)
+ * @param first Output for p'(x) (must not be NULL)
+ * @param second Output for p''(x) (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Derivatives are with respect to x, also for normalized polynomials.
+ */
+polyfit_error_t polyfit_evaluate_derivatives(const Polynomial* poly, float x,
+                                             float* value, float* first,
+                                             float* second);
+
+/**
+ * @brief Evaluate p, p' and p'' at many points
+ * @param poly Valid polynomial (must not be NULL)
+ * @param xs Array of evaluation points (must not be NULL)
+ * @param values Output array for p(x) (must not be NULL)
+ * @param firsts Output array for p'(x) (must not be NULL)
+ * @param seconds Output array for p''(x) (must not be NULL)
+ * @param num_points Number of points
+ * @return Error code indicating success or failure
+ */
+polyfit_error_t polyfit_evaluate_derivatives_batch(const Polynomial* poly,
+                                                   const float* xs,
+                                                   float* values, float* firsts,
+                                                   float* seconds,
+                                                   int32_t num_points);
+
+/**
+ * @brief Definite integral of a polynomial over [a, b]
+ * @param poly Valid polynomial (must not be NULL)
+ * @param a Lower limit
+ * @param b Upper limit (b < a gives the negated integral)
+ * @param result Output pointer for the integral (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note The antiderivative is evaluated in double at both limits, so no
+ * Polynomial is allocated and degree POLYFIT_MAX_DEGREE is supported.
+ */
+polyfit_error_t polyfit_integrate(const Polynomial* poly, float a, float b,
+                                  float* result);
+
+/*============================================================================*/
+/* INSTRUMENTATION FUNCTIONS                                                  */
+/*============================================================================*/
+
+/**
+ * @brief Copy the calling thread's counters
+ * @param stats Output snapshot (must not be NULL)
+ * @return Error code indicating success or failure
+ * @note Without POLYFIT_ENABLE_STATS the snapshot is all zero and
+ * stats->enabled is false.
+ */
+polyfit_error_t polyfit_stats_get(polyfit_stats_t* stats);
+
+/**
+ * @brief Zero the calling thread's counters
+ */
+void polyfit_stats_reset(void);
+
+/**
+ * @brief Install a callback run after every solve
+ * @param callback Function to call (NULL removes it)
+ * @param user_data Pointer passed back to the callback
+ * @return Error code indicating success or failure
+ * @note Not thread safe; install before other threads fit. The callback runs
+ * on the fitting thread and is never called without POLYFIT_ENABLE_STATS.
+ */
+polyfit_error_t polyfit_set_stats_callback(polyfit_stats_callback_t callback,
+                                           void* user_data);
+
 /*============================================================================*/
 /* UTILITY FUNCTIONS                                                          */
 /*============================================================================*/
@@ -0,0 +1,313 @@
+/**
+ ******************************************************************************
+ * @file    polyfit.hpp
+ * @brief   Header-only C++17 polynomial fitting for a compile-time degree
+ * @version 1.0
+ * @date    2025
+ ******************************************************************************
+ * @attention
+ *
+ * polyfit_cxx::Fit<Degree, T> fits, stores and evaluates a polynomial whose
+ * degree is known at compile time. Every loop over the degree is expanded
+ * at compile time, so the moment accumulation, the (Degree+1)x(Degree+1)
+ * solve and Horner evaluation contain no runtime trip counts. Results
+ * interoperate with the C Polynomial and polyfit_moments_t types.
+ *
+ * The namespace is polyfit_cxx because polyfit already names the C
+ * convenience function.
+ *
+ ******************************************************************************
+ */
+
+#ifndef POLYFIT_HPP_
+#define POLYFIT_HPP_
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "polyfit.h"
+
+namespace polyfit_cxx {
+
+namespace detail {
+
+template <typename F, std::size_t... I>
+constexpr void unroll_impl(F&& f, std::index_sequence<I...>) {
+  (f(std::integral_constant<std::size_t, I>{}), ...);
+}
+
+/**
+ * @brief Call f(integral_constant<0>) ... f(integral_constant<N-1>) with the
+ * loop expanded at compile time
+ */
+template <std::size_t N, typename F>
+constexpr void unroll(F&& f) {
+  unroll_impl(std::forward<F>(f), std::make_index_sequence<N>{});
+}
+
+}  // namespace detail
+
+/**
+ * @brief Least squares polynomial of a fixed degree
+ *
+ * Moments are accumulated in double, as in the C library. The normal
+ * equations are then solved in double, whereas the C library eliminates in
+ * float. Coefficients are stored as T. A default-constructed Fit is
+ * invalid until fit() or one of the conversions succeeds.
+ *
+ * @tparam Degree Polynomial degree (0 to POLYFIT_MAX_DEGREE)
+ * @tparam T Sample and coefficient type (float or double)
+ */
+template <int Degree, typename T = float>
+class Fit {
+  static_assert(Degree >= 0 && Degree <= POLYFIT_MAX_DEGREE,
+                "Degree must be in [0, POLYFIT_MAX_DEGREE]");
+  static_assert(std::is_floating_point<T>::value,
+                "T must be a floating point type");
+
+ public:
+  static constexpr int kDegree = Degree;
+  static constexpr std::size_t kSize = Degree + 1;
+  static constexpr std::size_t kPowers = 2 * Degree + 1;
+
+  /**
+   * @brief Fit the polynomial to a data set
+   * @param x Array of x values (must not be NULL)
+   * @param y Array of corresponding y values (must not be NULL)
+   * @param num_points Number of data points (must be > Degree)
+   * @return Error code indicating success or failure
+   */
+  polyfit_error_t fit(const T* x, const T* y, int32_t num_points) {
+    if (x == nullptr || y == nullptr) {
+      return POLYFIT_ERROR_NULL_POINTER;
+    }
+
+    if (num_points <= Degree) {
+      return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+    }
+
+    std::array<double, kPowers> power{};
+    std::array<double, kSize> cross{};
+
+    for (int32_t i = 0; i < num_points; i++) {
+      const double xi = static_cast<double>(x[i]);
+      const double yi = static_cast<double>(y[i]);
+      double p = 1.0;
+      detail::unroll<kPowers>([&](auto k) {
+        power[k] += p;
+        if constexpr (k < kSize) {
+          cross[k] += p * yi;
+        }
+        p *= xi;
+      });
+    }
+
+    // Any NaN or infinite input propagates into the sums; degree 0 never
+    // multiplies by x, so check the last power formed instead
+    bool finite = std::isfinite(power[kPowers - 1]);
+    if constexpr (Degree == 0) {
+      double sum_x = 0.0;
+      for (int32_t i = 0; i < num_points; i++) {
+        sum_x += static_cast<double>(x[i]);
+      }
+      finite = std::isfinite(sum_x);
+    }
+    detail::unroll<kSize>([&](auto k) {
+      finite = finite && std::isfinite(cross[k]);
+    });
+    if (!finite) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+
+    return solve(power, cross);
+  }
+
+  /**
+   * @brief Solve from moments computed by the C library
+   * @param moments Moments with moments.degree >= Degree
+   * @return Error code indicating success or failure
+   */
+  polyfit_error_t fit_moments(const polyfit_moments_t& moments) {
+    if (moments.degree < Degree) {
+      return POLYFIT_ERROR_INVALID_DEGREE;
+    }
+
+    if (moments.num_points <= Degree) {
+      return POLYFIT_ERROR_INSUFFICIENT_POINTS;
+    }
+
+    std::array<double, kPowers> power{};
+    std::array<double, kSize> cross{};
+    detail::unroll<kPowers>([&](auto k) { power[k] = moments.power_sums[k]; });
+    detail::unroll<kSize>([&](auto k) { cross[k] = moments.cross_sums[k]; });
+
+    return solve(power, cross);
+  }
+
+  /**
+   * @brief Evaluate the polynomial with unrolled Horner's method
+   */
+  T operator()(T x) const {
+    const T t = (x - x_offset_) * x_scale_;
+    T result = coefficients_[Degree];
+    detail::unroll<Degree>([&](auto k) {
+      result = result * t + coefficients_[Degree - 1 - k];
+    });
+    return result;
+  }
+
+  /**
+   * @brief Evaluate the polynomial at many points
+   * @param xs Array of evaluation points
+   * @param out Array to store the results
+   * @param num_points Number of points
+   */
+  void evaluate(const T* xs, T* out, int32_t num_points) const {
+    for (int32_t i = 0; i < num_points; i++) {
+      out[i] = (*this)(xs[i]);
+    }
+  }
+
+  /**
+   * @brief Copy into a C Polynomial of the same degree
+   * @param poly Polynomial from polyfit_init(Degree) (must not be NULL)
+   * @return Error code indicating success or failure
+   */
+  polyfit_error_t to_polynomial(Polynomial* poly) const {
+    if (poly == nullptr || poly->coefficients == nullptr) {
+      return POLYFIT_ERROR_NULL_POINTER;
+    }
+
+    if (!is_valid_) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+
+    if (poly->degree != Degree) {
+      return POLYFIT_ERROR_INVALID_DEGREE;
+    }
+
+    detail::unroll<kSize>([&](auto k) {
+      poly->coefficients[k] = static_cast<float>(coefficients_[k]);
+    });
+    poly->is_valid = true;
+    poly->is_normalized = is_normalized_;
+    poly->x_offset = static_cast<float>(x_offset_);
+    poly->x_scale = static_cast<float>(x_scale_);
+    return POLYFIT_SUCCESS;
+  }
+
+  /**
+   * @brief Load a C Polynomial of degree <= Degree
+   * @param poly Valid polynomial
+   * @return Error code indicating success or failure
+   * @note Missing high-order coefficients are zero; the domain mapping of a
+   * normalized polynomial is kept.
+   */
+  polyfit_error_t from_polynomial(const Polynomial& poly) {
+    if (!polyfit_is_valid(&poly)) {
+      return POLYFIT_ERROR_INVALID_INPUT;
+    }
+
+    if (poly.degree > Degree) {
+      return POLYFIT_ERROR_INVALID_DEGREE;
+    }
+
+    coefficients_.fill(T(0));
+    for (int32_t i = 0; i <= poly.degree; i++) {
+      coefficients_[i] = static_cast<T>(poly.coefficients[i]);
+    }
+    is_normalized_ = poly.is_normalized;
+    x_offset_ = poly.is_normalized ? static_cast<T>(poly.x_offset) : T(0);
+    x_scale_ = poly.is_normalized ? static_cast<T>(poly.x_scale) : T(1);
+    is_valid_ = true;
+    return POLYFIT_SUCCESS;
+  }
+
+  /** @brief Ascending coefficients */
+  const std::array<T, kSize>& coefficients() const { return coefficients_; }
+
+  /** @brief True once a fit or conversion has succeeded */
+  bool is_valid() const { return is_valid_; }
+
+ private:
+  polyfit_error_t solve(const std::array<double, kPowers>& power,
+                        const std::array<double, kSize>& cross) {
+    // Hankel normal matrix: A[i][j] = power[i + j]
+    std::array<std::array<double, kSize>, kSize> a{};
+    std::array<double, kSize> b = cross;
+    detail::unroll<kSize>([&](auto i) {
+      detail::unroll<kSize>([&](auto j) { a[i][j] = power[i + j]; });
+    });
+
+    // Forward elimination with partial pivoting
+    bool singular = false;
+    detail::unroll<kSize>([&](auto i) {
+      if (singular) {
+        return;
+      }
+
+      std::size_t max_row = i;
+      detail::unroll<kSize - i - 1>([&](auto r) {
+        constexpr std::size_t k = i + 1 + r;
+        if (std::fabs(a[k][i]) > std::fabs(a[max_row][i])) {
+          max_row = k;
+        }
+      });
+
+      if (std::fabs(a[max_row][i]) < 1e-12) {
+        singular = true;
+        return;
+      }
+
+      std::swap(a[i], a[max_row]);
+      std::swap(b[i], b[max_row]);
+
+      detail::unroll<kSize - i - 1>([&](auto r) {
+        constexpr std::size_t k = i + 1 + r;
+        const double factor = a[k][i] / a[i][i];
+        detail::unroll<kSize - i>([&](auto c) {
+          a[k][i + c] -= factor * a[i][i + c];
+        });
+        b[k] -= factor * b[i];
+      });
+    });
+
+    if (singular) {
+      return POLYFIT_ERROR_SINGULAR_MATRIX;
+    }
+
+    // Back substitution
+    std::array<double, kSize> solution{};
+    detail::unroll<kSize>([&](auto r) {
+      constexpr std::size_t i = kSize - 1 - r;
+      double value = b[i];
+      detail::unroll<kSize - i - 1>([&](auto c) {
+        value -= a[i][i + 1 + c] * solution[i + 1 + c];
+      });
+      solution[i] = value / a[i][i];
+    });
+
+    detail::unroll<kSize>([&](auto k) {
+      coefficients_[k] = static_cast<T>(solution[k]);
+    });
+    is_normalized_ = false;
+    x_offset_ = T(0);
+    x_scale_ = T(1);
+    is_valid_ = true;
+    return POLYFIT_SUCCESS;
+  }
+
+  std::array<T, kSize> coefficients_{};
+  T x_offset_ = T(0);
+  T x_scale_ = T(1);
+  bool is_normalized_ = false;
+  bool is_valid_ = false;
+};
+
+}  // namespace polyfit_cxx
+
+#endif /* POLYFIT_HPP_ */
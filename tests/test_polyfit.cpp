@@ -3,7 +3,11 @@ extern "C" {
 }
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 /*============================================================================*/
 /* SHARED TEST DATA                                                           */
@@ -185,6 +189,432 @@ TEST(PolyfitLeastSquares, InfInputRejected) {
     polyfit_free(p);
 }
 
+/*============================================================================*/
+/* DOMAIN NORMALIZATION                                                       */
+/*============================================================================*/
+
+TEST(PolyfitNormalized, HighDegreeFitOverAdcRange) {
+    // Degree-6 curve over 16-bit ADC codes: raw x^12 overflows float
+    const int n = 200;
+    float xs[n], ys[n];
+    for (int i = 0; i < n; i++) {
+        xs[i] = 65535.0f * (float)i / (float)(n - 1);
+        float t = xs[i] / 32767.5f - 1.0f;
+        ys[i] = 1.0f + t - 2.0f * t * t * t + 0.5f * t * t * t * t * t * t;
+    }
+
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    Polynomial *p = polyfit_init(6);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(polyfit_least_squares_ex(xs, ys, n, 6, &config, p),
+              POLYFIT_SUCCESS);
+    EXPECT_TRUE(p->is_normalized);
+
+    float out[n];
+    ASSERT_EQ(polyfit_evaluate_batch(p, xs, out, n), POLYFIT_SUCCESS);
+    for (int i = 0; i < n; i += 17) {
+        float single;
+        ASSERT_EQ(polyfit_evaluate(p, xs[i], &single), POLYFIT_SUCCESS);
+        EXPECT_NEAR(single, ys[i], 1e-3f) << "x = " << xs[i];
+        EXPECT_NEAR(out[i], single, 1e-4f) << "x = " << xs[i];
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitNormalized, DenormalizeMatchesNormalizedEvaluation) {
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(polyfit_least_squares_ex(kQuadX, kQuadY, kQuadN, 2, &config, p),
+              POLYFIT_SUCCESS);
+
+    float before;
+    ASSERT_EQ(polyfit_evaluate(p, 2.5f, &before), POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_denormalize(p), POLYFIT_SUCCESS);
+    EXPECT_FALSE(p->is_normalized);
+    EXPECT_NEAR(p->coefficients[0], 0.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 0.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[2], 1.0f, 1e-4f);
+
+    float after;
+    ASSERT_EQ(polyfit_evaluate(p, 2.5f, &after), POLYFIT_SUCCESS);
+    EXPECT_NEAR(before, after, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitNormalized, DefaultConfigMatchesPlainFit) {
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_least_squares_ex(kLinX, kLinY, kLinN, 1, nullptr, p),
+              POLYFIT_SUCCESS);
+    EXPECT_FALSE(p->is_normalized);
+    EXPECT_NEAR(p->coefficients[0], 1.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 2.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitNormalized, BankAppliesPerModelDomain) {
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(polyfit_least_squares_ex(kQuadX, kQuadY, kQuadN, 2, &config, p),
+              POLYFIT_SUCCESS);
+
+    const Polynomial *polys[] = {p};
+    polyfit_bank_t *bank = polyfit_bank_create_from(polys, 1);
+    ASSERT_NE(bank, nullptr);
+    float out;
+    EXPECT_EQ(polyfit_bank_evaluate_shared(bank, 4.0f, &out), POLYFIT_SUCCESS);
+    EXPECT_NEAR(out, 16.0f, 1e-3f);
+    polyfit_bank_free(bank);
+    polyfit_free(p);
+}
+
+/*============================================================================*/
+/* MOMENTS                                                                    */
+/*============================================================================*/
+
+TEST(PolyfitMoments, MatchesDirectSums) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 2, &m),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(m.degree, 2);
+    EXPECT_EQ(m.num_points, kQuadN);
+    for (int k = 0; k <= 4; k++) {
+        double expected = 0.0;
+        for (int i = 0; i < kQuadN; i++) expected += std::pow(kQuadX[i], k);
+        EXPECT_DOUBLE_EQ(m.power_sums[k], expected) << "power_sums[" << k << "]";
+    }
+    for (int k = 0; k <= 2; k++) {
+        double expected = 0.0;
+        for (int i = 0; i < kQuadN; i++)
+            expected += std::pow(kQuadX[i], k) * kQuadY[i];
+        EXPECT_DOUBLE_EQ(m.cross_sums[k], expected) << "cross_sums[" << k << "]";
+    }
+    double sum_y2 = 0.0;
+    for (int i = 0; i < kQuadN; i++) sum_y2 += (double)kQuadY[i] * kQuadY[i];
+    EXPECT_DOUBLE_EQ(m.sum_y2, sum_y2);
+}
+
+TEST(PolyfitMoments, LowerDegreeSolveMatchesDirectFit) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 4, &m),
+              POLYFIT_SUCCESS);
+
+    Polynomial *from_moments = polyfit_init(1);
+    Polynomial *direct = polyfit(kQuadX, kQuadY, kQuadN, 1, nullptr);
+    ASSERT_NE(from_moments, nullptr);
+    ASSERT_NE(direct, nullptr);
+    EXPECT_EQ(polyfit_fit_moments(&m, 1, from_moments), POLYFIT_SUCCESS);
+    EXPECT_NEAR(from_moments->coefficients[0], direct->coefficients[0], 1e-5f);
+    EXPECT_NEAR(from_moments->coefficients[1], direct->coefficients[1], 1e-5f);
+    polyfit_free(from_moments);
+    polyfit_free(direct);
+}
+
+TEST(PolyfitMoments, DegreeAboveMomentsReturnsError) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kLinX, kLinY, kLinN, 1, &m),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_fit_moments(&m, 2, p), POLYFIT_ERROR_INVALID_DEGREE);
+    polyfit_free(p);
+}
+
+// Large enough to span several POLYFIT_PARALLEL_BLOCK_SIZE blocks
+static void fill_parallel_data(std::vector<float> &x, std::vector<float> &y) {
+    const int n = 3 * POLYFIT_PARALLEL_BLOCK_SIZE + 1234;
+    x.resize(n);
+    y.resize(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = -1.0f + 2.0f * (float)i / (float)(n - 1);
+        y[i] = 0.5f - x[i] + 2.0f * x[i] * x[i] + 0.01f * std::sin(37.0f * i);
+    }
+}
+
+TEST(PolyfitMoments, ParallelIsBitIdenticalAcrossThreadCounts) {
+    std::vector<float> x, y;
+    fill_parallel_data(x, y);
+    const int n = (int)x.size();
+
+    polyfit_moments_t ref;
+    ASSERT_EQ(polyfit_compute_moments_parallel(x.data(), y.data(), n, 2, 1,
+                                               &ref),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(ref.num_points, n);
+
+    for (int threads : {2, 3, 8, POLYFIT_MAX_THREADS + 1}) {
+        polyfit_moments_t m;
+        ASSERT_EQ(polyfit_compute_moments_parallel(x.data(), y.data(), n, 2,
+                                                   threads, &m),
+                  POLYFIT_SUCCESS);
+        EXPECT_EQ(std::memcmp(m.power_sums, ref.power_sums,
+                              sizeof(ref.power_sums)), 0) << threads;
+        EXPECT_EQ(std::memcmp(m.cross_sums, ref.cross_sums,
+                              sizeof(ref.cross_sums)), 0) << threads;
+        EXPECT_EQ(std::memcmp(&m.sum_y2, &ref.sum_y2, sizeof(double)), 0)
+            << threads;
+    }
+}
+
+TEST(PolyfitMoments, ParallelFitMatchesSequentialFit) {
+    std::vector<float> x, y;
+    fill_parallel_data(x, y);
+    const int n = (int)x.size();
+
+    polyfit_config_t config = polyfit_default_config();
+    Polynomial *seq = polyfit_init(2);
+    Polynomial *par = polyfit_init(2);
+    ASSERT_NE(seq, nullptr);
+    ASSERT_NE(par, nullptr);
+    ASSERT_EQ(polyfit_least_squares_ex(x.data(), y.data(), n, 2, &config, seq),
+              POLYFIT_SUCCESS);
+    config.num_threads = 4;
+    ASSERT_EQ(polyfit_least_squares_ex(x.data(), y.data(), n, 2, &config, par),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_NEAR(par->coefficients[i], seq->coefficients[i], 1e-4f);
+    }
+    EXPECT_FALSE(par->is_normalized);
+    polyfit_free(seq);
+    polyfit_free(par);
+}
+
+TEST(PolyfitMoments, ParallelRejectsBadArguments) {
+    polyfit_moments_t m;
+    EXPECT_EQ(polyfit_compute_moments_parallel(kLinX, kLinY, kLinN, 1, 0, &m),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_compute_moments_parallel(nullptr, kLinY, kLinN, 1, 2, &m),
+              POLYFIT_ERROR_NULL_POINTER);
+}
+
+TEST(PolyfitMoments, MergedChunksMatchWholeSet) {
+    polyfit_moments_t whole, head, tail;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 2, &whole),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, 4, 2, &head),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_compute_moments(kQuadX + 4, kQuadY + 4, kQuadN - 4, 2,
+                                      &tail),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_moments_merge(&head, &tail), POLYFIT_SUCCESS);
+    EXPECT_EQ(head.num_points, whole.num_points);
+    for (int k = 0; k <= 4; k++) {
+        EXPECT_DOUBLE_EQ(head.power_sums[k], whole.power_sums[k]);
+    }
+    EXPECT_DOUBLE_EQ(head.sum_y2, whole.sum_y2);
+
+    polyfit_moments_t other;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 3, &other),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_moments_merge(&head, &other),
+              POLYFIT_ERROR_INVALID_DEGREE);
+}
+
+TEST(PolyfitMoments, NaNXRejectedAtDegreeZero) {
+    float xi[] = {1.0f, 0.0f / 0.0f, 3.0f};
+    float yi[] = {1.0f, 2.0f, 3.0f};
+    polyfit_moments_t m;
+    EXPECT_EQ(polyfit_compute_moments(xi, yi, 3, 0, &m),
+              POLYFIT_ERROR_INVALID_INPUT);
+}
+
+TEST(PolyfitMoments, NullPointersReturnError) {
+    polyfit_moments_t m;
+    EXPECT_EQ(polyfit_compute_moments(nullptr, kLinY, kLinN, 1, &m),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_compute_moments(kLinX, kLinY, kLinN, 1, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_fit_moments(nullptr, 1, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+}
+
+/*============================================================================*/
+/* TYPED INPUTS                                                               */
+/*============================================================================*/
+
+TEST(PolyfitTyped, ScaledInt16MatchesConvertedFloat) {
+    const int16_t codes[] = {-300, -100, 0, 50, 200, 400, 1000};
+    const uint16_t raw_y[] = {10, 40, 70, 90, 160, 250, 700};
+    float xf[7], yf[7];
+    for (int i = 0; i < 7; i++) {
+        xf[i] = codes[i] * 0.001f + 0.5f;
+        yf[i] = raw_y[i] * 0.01f;
+    }
+
+    polyfit_input_t x = polyfit_input(codes, POLYFIT_TYPE_INT16);
+    x.scale = 0.001;
+    x.offset = 0.5;
+    polyfit_input_t y = polyfit_input(raw_y, POLYFIT_TYPE_UINT16);
+    y.scale = 0.01;
+
+    Polynomial *typed = polyfit_init(2);
+    Polynomial *plain = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_typed(&x, &y, 7, 2, nullptr, typed),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares(xf, yf, 7, 2, plain), POLYFIT_SUCCESS);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_NEAR(typed->coefficients[i], plain->coefficients[i], 1e-3f);
+    }
+    polyfit_free(typed);
+    polyfit_free(plain);
+}
+
+TEST(PolyfitTyped, Int64TimestampsAreRebased) {
+    // Nanosecond timestamps near 2024; float or double x would lose the
+    // microsecond spacing entirely
+    const int64_t t0 = 1700000000000000000LL;
+    int64_t t[20];
+    double y[20];
+    for (int i = 0; i < 20; i++) {
+        t[i] = t0 + 1000LL * i;
+        y[i] = 3.0 + 0.002 * (1000.0 * i);
+    }
+
+    polyfit_input_t x = polyfit_input(t, POLYFIT_TYPE_INT64);
+    EXPECT_EQ(x.origin, t0);
+    x.scale = 1e-3;  // ns -> us
+    polyfit_input_t yi = polyfit_input(y, POLYFIT_TYPE_DOUBLE);
+
+    Polynomial *p = polyfit_init(1);
+    ASSERT_EQ(polyfit_least_squares_typed(&x, &yi, 20, 1, nullptr, p),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[0], 3.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 2.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitTyped, NormalizedInt32Domain) {
+    const int32_t x_raw[] = {100000, 100010, 100020, 100030, 100040};
+    const float y_raw[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+    polyfit_input_t x = polyfit_input(x_raw, POLYFIT_TYPE_INT32);
+    polyfit_input_t y = polyfit_input(y_raw, POLYFIT_TYPE_FLOAT);
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+
+    Polynomial *p = polyfit_init(1);
+    ASSERT_EQ(polyfit_least_squares_typed(&x, &y, 5, 1, &config, p),
+              POLYFIT_SUCCESS);
+    EXPECT_TRUE(p->is_normalized);
+    float value;
+    ASSERT_EQ(polyfit_evaluate(p, 100025.0f, &value), POLYFIT_SUCCESS);
+    EXPECT_NEAR(value, 3.5f, 1e-3f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitTyped, MomentsAndErrors) {
+    const double xd[] = {0.0, 1.0, 2.0, 3.0, 4.0};
+    const double yd[] = {1.0, 3.0, 5.0, 7.0, 9.0};
+    polyfit_input_t x = polyfit_input(xd, POLYFIT_TYPE_DOUBLE);
+    polyfit_input_t y = polyfit_input(yd, POLYFIT_TYPE_DOUBLE);
+
+    polyfit_moments_t typed, plain;
+    ASSERT_EQ(polyfit_compute_moments_typed(&x, &y, 5, 1, &typed),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_compute_moments(kLinX, kLinY, kLinN, 1, &plain),
+              POLYFIT_SUCCESS);
+    for (int k = 0; k <= 2; k++) {
+        EXPECT_DOUBLE_EQ(typed.power_sums[k], plain.power_sums[k]);
+    }
+
+    polyfit_input_t bad = x;
+    bad.type = static_cast<polyfit_type_t>(42);
+    EXPECT_EQ(polyfit_compute_moments_typed(&bad, &y, 5, 1, &typed),
+              POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_input_t missing = polyfit_input(nullptr, POLYFIT_TYPE_INT64);
+    Polynomial *p = polyfit_init(1);
+    EXPECT_EQ(polyfit_least_squares_typed(&missing, &y, 5, 1, nullptr, p),
+              POLYFIT_ERROR_NULL_POINTER);
+    polyfit_free(p);
+}
+
+TEST(PolyfitTyped, InterleavedBufferMatchesDenseArrays) {
+    float xy[2 * kQuadN];
+    for (int i = 0; i < kQuadN; i++) {
+        xy[2 * i] = kQuadX[i];
+        xy[2 * i + 1] = kQuadY[i];
+    }
+    polyfit_input_t x = polyfit_input(xy, POLYFIT_TYPE_FLOAT);
+    polyfit_input_t y = polyfit_input(xy + 1, POLYFIT_TYPE_FLOAT);
+    x.stride = y.stride = 2 * sizeof(float);
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_typed(&x, &y, kQuadN, 2, nullptr, p),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[2], 1.0f, 1e-4f);
+
+    float typed_res[kQuadN], plain_res[kQuadN];
+    ASSERT_EQ(polyfit_compute_residuals_typed(p, &x, &y, kQuadN, typed_res),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_compute_residuals(p, kQuadX, kQuadY, kQuadN, plain_res),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i < kQuadN; i++) {
+        EXPECT_FLOAT_EQ(typed_res[i], plain_res[i]);
+    }
+
+    float typed_r2, plain_r2;
+    ASSERT_EQ(polyfit_r_squared_typed(p, &x, &y, kQuadN, &typed_r2),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_r_squared(p, kQuadX, kQuadY, kQuadN, &plain_r2),
+              POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(typed_r2, plain_r2);
+    polyfit_free(p);
+}
+
+TEST(PolyfitTyped, ArrayOfStructsWithImplicitX) {
+    struct Record {
+        int64_t timestamp;
+        float value;
+        uint32_t flags;
+    };
+    Record records[300];
+    for (int i = 0; i < 300; i++) {
+        float xi = 0.5f + 0.25f * i;
+        records[i] = {1000LL * i, 2.0f - 0.5f * xi + 0.01f * xi * xi, 0u};
+    }
+
+    polyfit_input_t x = polyfit_input_index(0.5, 0.25);
+    polyfit_input_t y = polyfit_input(&records[0].value, POLYFIT_TYPE_FLOAT);
+    y.stride = sizeof(Record);
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_typed(&x, &y, 300, 2, nullptr, p),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[0], 2.0f, 1e-2f);
+    EXPECT_NEAR(p->coefficients[1], -0.5f, 1e-3f);
+    EXPECT_NEAR(p->coefficients[2], 0.01f, 1e-4f);
+
+    float r2 = 0.0f;
+    ASSERT_EQ(polyfit_r_squared_typed(p, &x, &y, 300, &r2), POLYFIT_SUCCESS);
+    EXPECT_GT(r2, 0.9999f);
+
+    // The timestamp field of the same records works as an int64 axis
+    polyfit_input_t t = polyfit_input(&records[0].timestamp,
+                                      POLYFIT_TYPE_INT64);
+    t.stride = sizeof(Record);
+    t.scale = 0.00025;
+    t.offset = 0.5;
+    Polynomial *q = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_typed(&t, &y, 300, 2, nullptr, q),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(q->coefficients[2], p->coefficients[2], 1e-5f);
+    polyfit_free(p);
+    polyfit_free(q);
+}
+
+TEST(PolyfitTyped, NegativeStrideRejected) {
+    polyfit_input_t x = polyfit_input_index(0.0, 1.0);
+    polyfit_input_t y = polyfit_input(kLinY, POLYFIT_TYPE_FLOAT);
+    y.stride = -4;
+    polyfit_moments_t m;
+    EXPECT_EQ(polyfit_compute_moments_typed(&x, &y, kLinN, 1, &m),
+              POLYFIT_ERROR_INVALID_INPUT);
+}
+
 /*============================================================================*/
 /* EVALUATE                                                                   */
 /*============================================================================*/
@@ -228,6 +658,103 @@ TEST(PolyfitEvaluate, SmallLegitimateValueNotSnappedToZero) {
     polyfit_free(p);
 }
 
+TEST(PolyfitEvaluate, EstrinMatchesHornerAtEveryDegree) {
+    for (int degree = 0; degree <= POLYFIT_MAX_DEGREE; degree++) {
+        Polynomial *p = polyfit_init(degree);
+        ASSERT_NE(p, nullptr);
+        for (int k = 0; k <= degree; k++) {
+            p->coefficients[k] = ((k & 1) ? -1.0f : 1.0f) / (float)(k + 1);
+        }
+        for (float x = -1.5f; x <= 1.5f; x += 0.125f) {
+            double reference = 0.0;
+            for (int k = degree; k >= 0; k--) {
+                reference = reference * x + p->coefficients[k];
+            }
+            float horner, estrin, chosen;
+            ASSERT_EQ(polyfit_evaluate_horner(p, x, &horner),
+                      POLYFIT_SUCCESS);
+            ASSERT_EQ(polyfit_evaluate_estrin(p, x, &estrin),
+                      POLYFIT_SUCCESS);
+            ASSERT_EQ(polyfit_evaluate(p, x, &chosen), POLYFIT_SUCCESS);
+            EXPECT_NEAR(estrin, reference, 1e-5) << degree << " " << x;
+            EXPECT_NEAR(horner, reference, 1e-5) << degree << " " << x;
+            EXPECT_EQ(chosen,
+                      degree >= POLYFIT_ESTRIN_MIN_DEGREE ? estrin : horner);
+        }
+        polyfit_free(p);
+    }
+}
+
+TEST(PolyfitEvaluateBatch, MatchesScalarEvaluate) {
+    Polynomial *p = polyfit_init(5);
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i <= 5; i++) p->coefficients[i] = 0.5f - 0.25f * (float)i;
+
+    // 37 points exercise every vector width plus a scalar tail
+    float xs[37], out[37];
+    for (int i = 0; i < 37; i++) xs[i] = -2.0f + 0.1f * (float)i;
+    EXPECT_EQ(polyfit_evaluate_batch(p, xs, out, 37), POLYFIT_SUCCESS);
+    for (int i = 0; i < 37; i++) {
+        float expected;
+        ASSERT_EQ(polyfit_evaluate(p, xs[i], &expected), POLYFIT_SUCCESS);
+        EXPECT_NEAR(out[i], expected, 1e-5f * (1.0f + std::fabs(expected)))
+            << "xs[" << i << "]";
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitEvaluateBatch, ResultIndependentOfPosition) {
+    // Degree 10 with a normalized domain: any fused/unfused mismatch between
+    // the vector widths and the tail shows up in the last bits
+    Polynomial *p = polyfit_init(10);
+    ASSERT_NE(p, nullptr);
+    for (int k = 0; k <= 10; k++) {
+        p->coefficients[k] = ((k & 1) ? -1.0f : 1.0f) / (float)(k + 1);
+    }
+    p->is_normalized = true;
+    p->x_offset = 0.3f;
+    p->x_scale = 0.7f;
+
+    // 37 copies reach every vector width and the tail
+    float xs[37], out[37];
+    for (int j = 0; j < 2000; j++) {
+        const float x = -1.7f + 3.4f * (float)j / 1999.0f;
+        for (int i = 0; i < 37; i++) xs[i] = x;
+        ASSERT_EQ(polyfit_evaluate_batch(p, xs, out, 37), POLYFIT_SUCCESS);
+        float single;
+        ASSERT_EQ(polyfit_evaluate_horner(p, x, &single), POLYFIT_SUCCESS);
+        for (int i = 0; i < 37; i++) {
+            ASSERT_EQ(out[i], out[0]) << "x " << x << " position " << i;
+        }
+        ASSERT_EQ(out[0], single) << "x " << x;
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitEvaluateBatch, InPlace) {
+    Polynomial *p = polyfit(kLinX, kLinY, kLinN, 1, nullptr);
+    ASSERT_NE(p, nullptr);
+    float buf[] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    EXPECT_EQ(polyfit_evaluate_batch(p, buf, buf, 9), POLYFIT_SUCCESS);
+    for (int i = 0; i < 9; i++) {
+        EXPECT_NEAR(buf[i], 2.0f * (float)i + 1.0f, 1e-4f);
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitEvaluateBatch, NullArgumentsReturnError) {
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    float buf[4] = {0};
+    EXPECT_EQ(polyfit_evaluate_batch(nullptr, buf, buf, 4),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_evaluate_batch(p, nullptr, buf, 4),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_evaluate_batch(p, buf, nullptr, 4),
+              POLYFIT_ERROR_NULL_POINTER);
+    polyfit_free(p);
+}
+
 /*============================================================================*/
 /* CONVENIENCE FUNCTIONS                                                      */
 /*============================================================================*/
@@ -455,6 +982,1580 @@ TEST(PolyfitBestDegree, InsufficientPoints) {
     EXPECT_EQ(err, POLYFIT_ERROR_INSUFFICIENT_POINTS);
 }
 
+TEST(PolyfitBestDegree, MomentsPathMatchesArrayPath) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 5, &m),
+              POLYFIT_SUCCESS);
+    int32_t deg;
+    polyfit_error_t err;
+    Polynomial *p = polyfit_best_degree_moments(&m, 5, 0, &deg, &err);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(err, POLYFIT_SUCCESS);
+    EXPECT_EQ(deg, 2);
+    EXPECT_NEAR(p->coefficients[2], 1.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitBestDegree, EarlyTerminationKeepsBest) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 6, &m),
+              POLYFIT_SUCCESS);
+    int32_t deg;
+    Polynomial *p = polyfit_best_degree_moments(&m, 6, 1, &deg, nullptr);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(deg, 2);
+    polyfit_free(p);
+}
+
+TEST(PolyfitBestDegree, MomentsDegreeTooLow) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 2, &m),
+              POLYFIT_SUCCESS);
+    int32_t deg;
+    polyfit_error_t err;
+    EXPECT_EQ(polyfit_best_degree_moments(&m, 3, 0, &deg, &err), nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INVALID_DEGREE);
+}
+
+TEST(PolyfitMomentsRss, MatchesDirectResidualSum) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 1, &m),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit(kQuadX, kQuadY, kQuadN, 1, nullptr);
+    ASSERT_NE(p, nullptr);
+
+    float residuals[kQuadN];
+    ASSERT_EQ(polyfit_compute_residuals(p, kQuadX, kQuadY, kQuadN, residuals),
+              POLYFIT_SUCCESS);
+    double direct = 0.0;
+    for (int i = 0; i < kQuadN; i++) direct += residuals[i] * residuals[i];
+
+    double rss;
+    EXPECT_EQ(polyfit_moments_rss(&m, p, &rss), POLYFIT_SUCCESS);
+    EXPECT_NEAR(rss, direct, 1e-3 * direct);
+    polyfit_free(p);
+}
+
+TEST(PolyfitMomentsRss, RejectsNormalizedPolynomial) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kLinX, kLinY, kLinN, 1, &m),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    p->is_normalized = true;
+    p->x_scale = 1.0f;
+    double rss;
+    EXPECT_EQ(polyfit_moments_rss(&m, p, &rss), POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_free(p);
+}
+
+TEST(PolyfitQuality, FusedFitMatchesDataPasses) {
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    polyfit_quality_t q;
+    ASSERT_EQ(polyfit_least_squares_quality(kQuadX, kQuadY, kQuadN, 1,
+                                            nullptr, p, &q),
+              POLYFIT_SUCCESS);
+
+    float r2;
+    ASSERT_EQ(polyfit_r_squared(p, kQuadX, kQuadY, kQuadN, &r2),
+              POLYFIT_SUCCESS);
+    float residuals[kQuadN];
+    ASSERT_EQ(polyfit_compute_residuals(p, kQuadX, kQuadY, kQuadN, residuals),
+              POLYFIT_SUCCESS);
+    double rss = 0.0;
+    for (int i = 0; i < kQuadN; i++) rss += residuals[i] * residuals[i];
+
+    EXPECT_NEAR(q.rss, rss, 1e-3 * rss);
+    EXPECT_NEAR(q.r_squared, r2, 1e-4f);
+    EXPECT_EQ(q.num_points, kQuadN);
+    EXPECT_EQ(q.dof, kQuadN - 2);
+    EXPECT_LT(q.adj_r_squared, q.r_squared);
+    EXPECT_NEAR(q.residual_std_error, std::sqrt(rss / (kQuadN - 2)), 1e-3);
+    const double n = kQuadN;
+    EXPECT_NEAR(q.aic, n * std::log(rss / n) + 4.0, 1e-3);
+    EXPECT_NEAR(q.bic, n * std::log(rss / n) + 2.0 * std::log(n), 1e-3);
+    polyfit_free(p);
+}
+
+TEST(PolyfitQuality, NormalizedDomainGivesSameStatistics) {
+    polyfit_config_t config = polyfit_default_config();
+    Polynomial *raw = polyfit_init(2);
+    Polynomial *norm = polyfit_init(2);
+    polyfit_quality_t q_raw, q_norm;
+    ASSERT_EQ(polyfit_least_squares_quality(kQuadX, kQuadY, kQuadN, 2,
+                                            &config, raw, &q_raw),
+              POLYFIT_SUCCESS);
+    config.normalize_domain = true;
+    ASSERT_EQ(polyfit_least_squares_quality(kQuadX, kQuadY, kQuadN, 2,
+                                            &config, norm, &q_norm),
+              POLYFIT_SUCCESS);
+    EXPECT_TRUE(norm->is_normalized);
+    EXPECT_NEAR(q_norm.r_squared, q_raw.r_squared, 1e-5f);
+    EXPECT_NEAR(q_norm.r_squared, 1.0f, 1e-5f);
+    EXPECT_NEAR(q_norm.tss, q_raw.tss, 1e-6 * q_raw.tss);
+    polyfit_free(raw);
+    polyfit_free(norm);
+}
+
+TEST(PolyfitQuality, MomentsQualityValidatesArguments) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kLinX, kLinY, kLinN, 1, &m),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(2);
+    polyfit_quality_t q;
+    EXPECT_EQ(polyfit_moments_quality(&m, p, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_moments_quality(&m, p, &q),
+              POLYFIT_ERROR_INVALID_DEGREE);
+    EXPECT_EQ(polyfit_least_squares_quality(kLinX, kLinY, kLinN, 1, nullptr,
+                                            p, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+    polyfit_free(p);
+}
+
+/*============================================================================*/
+/* WEIGHTED FITTING                                                           */
+/*============================================================================*/
+
+TEST(PolyfitWeighted, IntegerWeightsMatchRepeatedPoints) {
+    const float x[] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+    const float y[] = {1.0f, 2.5f, 5.5f, 6.0f, 9.5f};
+    const float w[] = {1.0f, 3.0f, 1.0f, 2.0f, 1.0f};
+    const float xr[] = {0.0f, 1.0f, 1.0f, 1.0f, 2.0f, 3.0f, 3.0f, 4.0f};
+    const float yr[] = {1.0f, 2.5f, 2.5f, 2.5f, 5.5f, 6.0f, 6.0f, 9.5f};
+
+    Polynomial *weighted = polyfit_init(2);
+    Polynomial *repeated = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_weighted(x, y, w, 5, 2, nullptr, weighted),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares(xr, yr, 8, 2, repeated), POLYFIT_SUCCESS);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_NEAR(weighted->coefficients[i], repeated->coefficients[i],
+                    1e-4f);
+    }
+
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments_weighted(x, y, w, 5, 2, &m),
+              POLYFIT_SUCCESS);
+    EXPECT_DOUBLE_EQ(m.power_sums[0], 8.0);
+    EXPECT_EQ(m.num_points, 5);
+    polyfit_free(weighted);
+    polyfit_free(repeated);
+}
+
+TEST(PolyfitWeighted, ZeroWeightIgnoresOutlier) {
+    const float x[] = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+    const float y[] = {1.0f, 3.0f, 5.0f, 100.0f, 9.0f, 11.0f};
+    const float w[] = {1.0f, 0.5f, 1.0f, 0.0f, 1.0f, 0.25f};
+
+    Polynomial *p = polyfit_init(1);
+    ASSERT_EQ(polyfit_least_squares_weighted(x, y, w, 6, 1, nullptr, p),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[0], 1.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 2.0f, 1e-4f);
+
+    float r2 = 0.0f;
+    ASSERT_EQ(polyfit_r_squared_weighted(p, x, y, w, 6, &r2),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(r2, 1.0f, 1e-5f);
+
+    float res[6];
+    ASSERT_EQ(polyfit_compute_residuals_weighted(p, x, y, w, 6, res),
+              POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(res[3], 0.0f);
+    EXPECT_NEAR(res[1], 0.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitWeighted, UnitWeightsMatchUnweighted) {
+    std::vector<float> ones(kQuadN, 1.0f);
+    Polynomial *p = polyfit(kQuadX, kQuadY, kQuadN, 1, nullptr);
+    ASSERT_NE(p, nullptr);
+    float r2 = 0.0f, r2w = 0.0f;
+    ASSERT_EQ(polyfit_r_squared(p, kQuadX, kQuadY, kQuadN, &r2),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_r_squared_weighted(p, kQuadX, kQuadY, ones.data(),
+                                         kQuadN, &r2w),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(r2w, r2, 1e-6f);
+    polyfit_free(p);
+
+    int32_t deg = -1;
+    Polynomial *best = polyfit_best_degree_weighted(
+        kQuadX, kQuadY, ones.data(), kQuadN, 4, &deg, nullptr);
+    ASSERT_NE(best, nullptr);
+    EXPECT_EQ(deg, 2);
+    polyfit_free(best);
+}
+
+TEST(PolyfitWeighted, NegativeWeightRejected) {
+    const float w[] = {1.0f, 1.0f, -1.0f, 1.0f, 1.0f};
+    polyfit_error_t err = POLYFIT_SUCCESS;
+    int32_t deg;
+    Polynomial *p = polyfit_init(1);
+    EXPECT_EQ(polyfit_least_squares_weighted(kLinX, kLinY, w, kLinN, 1,
+                                             nullptr, p),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_best_degree_weighted(kLinX, kLinY, w, kLinN, 2, &deg,
+                                           &err),
+              nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_least_squares_weighted(kLinX, kLinY, nullptr, kLinN, 1,
+                                             nullptr, p),
+              POLYFIT_ERROR_NULL_POINTER);
+
+    // A bad weight leaves the residual buffer untouched
+    ASSERT_EQ(polyfit_least_squares(kLinX, kLinY, kLinN, 1, p),
+              POLYFIT_SUCCESS);
+    float res[] = {-7.0f, -7.0f, -7.0f, -7.0f, -7.0f};
+    EXPECT_EQ(polyfit_compute_residuals_weighted(p, kLinX, kLinY, w, kLinN,
+                                                 res),
+              POLYFIT_ERROR_INVALID_INPUT);
+    for (float r : res) {
+        EXPECT_EQ(r, -7.0f);
+    }
+    polyfit_free(p);
+}
+
+/*============================================================================*/
+/* INCREMENTAL ACCUMULATOR                                                    */
+/*============================================================================*/
+
+TEST(PolyfitAccumulator, PointByPointMatchesBatchFit) {
+    polyfit_accumulator_t acc;
+    ASSERT_EQ(polyfit_accumulator_init(&acc, 2), POLYFIT_SUCCESS);
+    for (int i = 0; i < kQuadN; i++) {
+        EXPECT_EQ(polyfit_accumulator_add_point(&acc, kQuadX[i], kQuadY[i]),
+                  POLYFIT_SUCCESS);
+    }
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_accumulator_solve(&acc, p), POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[0], 0.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 0.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[2], 1.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitAccumulator, RemovePointUndoesAdd) {
+    polyfit_accumulator_t acc;
+    ASSERT_EQ(polyfit_accumulator_init(&acc, 1), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_accumulator_add_points(&acc, kLinX, kLinY, kLinN),
+              POLYFIT_SUCCESS);
+    // An outlier that is later retracted must not affect the fit
+    ASSERT_EQ(polyfit_accumulator_add_point(&acc, 2.0f, 100.0f), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_accumulator_remove_point(&acc, 2.0f, 100.0f),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(acc.moments.num_points, kLinN);
+
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_accumulator_solve(&acc, p), POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[0], 1.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 2.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitAccumulator, SolveIsLazy) {
+    polyfit_accumulator_t acc;
+    ASSERT_EQ(polyfit_accumulator_init(&acc, 1), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_accumulator_add_points(&acc, kLinX, kLinY, kLinN),
+              POLYFIT_SUCCESS);
+    EXPECT_TRUE(acc.is_dirty);
+
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_accumulator_solve(&acc, p), POLYFIT_SUCCESS);
+    EXPECT_FALSE(acc.is_dirty);
+    EXPECT_EQ(polyfit_accumulator_solve(&acc, p), POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[1], 2.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitAccumulator, InsufficientPoints) {
+    polyfit_accumulator_t acc;
+    ASSERT_EQ(polyfit_accumulator_init(&acc, 2), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_accumulator_add_point(&acc, 1.0f, 1.0f), POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_accumulator_solve(&acc, p),
+              POLYFIT_ERROR_INSUFFICIENT_POINTS);
+    polyfit_free(p);
+}
+
+TEST(PolyfitAccumulator, NonFiniteBatchLeavesStateUntouched) {
+    float xi[] = {1.0f, 2.0f, 3.0f};
+    float yi[] = {1.0f, 1.0f / 0.0f, 3.0f};
+    polyfit_accumulator_t acc;
+    ASSERT_EQ(polyfit_accumulator_init(&acc, 1), POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_accumulator_add_points(&acc, xi, yi, 3),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(acc.moments.num_points, 0);
+    EXPECT_EQ(polyfit_accumulator_add_point(&acc, 0.0f / 0.0f, 1.0f),
+              POLYFIT_ERROR_INVALID_INPUT);
+}
+
+TEST(PolyfitAccumulator, RemoveFromEmptyReturnsError) {
+    polyfit_accumulator_t acc;
+    ASSERT_EQ(polyfit_accumulator_init(&acc, 1), POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_accumulator_remove_point(&acc, 1.0f, 1.0f),
+              POLYFIT_ERROR_INVALID_INPUT);
+}
+
+TEST(PolyfitAccumulator, InitInvalidDegree) {
+    polyfit_accumulator_t acc;
+    EXPECT_EQ(polyfit_accumulator_init(&acc, POLYFIT_MAX_DEGREE + 1),
+              POLYFIT_ERROR_INVALID_DEGREE);
+    EXPECT_EQ(polyfit_accumulator_init(nullptr, 1), POLYFIT_ERROR_NULL_POINTER);
+}
+
+/*============================================================================*/
+/* SLIDING WINDOW                                                             */
+/*============================================================================*/
+
+TEST(PolyfitWindow, MatchesDirectFitOfLastSamples) {
+    polyfit_window_t *w = polyfit_window_create(5, 1);
+    ASSERT_NE(w, nullptr);
+    // Quadratic stream: the window only ever sees the last 5 samples
+    for (int i = 0; i < kQuadN; i++) {
+        EXPECT_EQ(polyfit_window_push(w, kQuadX[i], kQuadY[i]), POLYFIT_SUCCESS);
+    }
+
+    Polynomial *windowed = polyfit_init(1);
+    Polynomial *direct = polyfit(kQuadX + kQuadN - 5, kQuadY + kQuadN - 5, 5, 1,
+                                 nullptr);
+    ASSERT_NE(windowed, nullptr);
+    ASSERT_NE(direct, nullptr);
+    EXPECT_EQ(polyfit_window_solve(w, windowed, nullptr), POLYFIT_SUCCESS);
+    EXPECT_TRUE(windowed->is_normalized);
+    EXPECT_EQ(polyfit_denormalize(windowed), POLYFIT_SUCCESS);
+    EXPECT_NEAR(windowed->coefficients[0], direct->coefficients[0], 1e-3f);
+    EXPECT_NEAR(windowed->coefficients[1], direct->coefficients[1], 1e-3f);
+
+    polyfit_free(windowed);
+    polyfit_free(direct);
+    polyfit_window_free(w);
+}
+
+TEST(PolyfitWindow, NewestValueStaysAccurateOnLongOffsetStream) {
+    // y = 0.5*(x - 3000)^2 + 2 at large x, pushed well past many rebuilds
+    polyfit_window_t *w = polyfit_window_create(32, 2);
+    ASSERT_NE(w, nullptr);
+    float x = 0.0f;
+    for (int i = 0; i < 1000; i++) {
+        x = 2500.0f + 0.5f * (float)i;
+        float dx = x - 3000.0f;
+        ASSERT_EQ(polyfit_window_push(w, x, 0.5f * dx * dx + 2.0f),
+                  POLYFIT_SUCCESS);
+    }
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    float newest;
+    EXPECT_EQ(polyfit_window_solve(w, p, &newest), POLYFIT_SUCCESS);
+    float dx = x - 3000.0f;
+    EXPECT_NEAR(newest, 0.5f * dx * dx + 2.0f, 1e-2f);
+    polyfit_free(p);
+    polyfit_window_free(w);
+}
+
+TEST(PolyfitWindow, InsufficientPointsWhileFilling) {
+    polyfit_window_t *w = polyfit_window_create(8, 2);
+    ASSERT_NE(w, nullptr);
+    ASSERT_EQ(polyfit_window_push(w, 1.0f, 1.0f), POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_window_solve(w, p, nullptr),
+              POLYFIT_ERROR_INSUFFICIENT_POINTS);
+    polyfit_free(p);
+    polyfit_window_free(w);
+}
+
+TEST(PolyfitWindow, InvalidArguments) {
+    EXPECT_EQ(polyfit_window_create(2, 2), nullptr);  // capacity must exceed degree
+    EXPECT_EQ(polyfit_window_create(16, POLYFIT_MAX_DEGREE + 1), nullptr);
+    EXPECT_EQ(polyfit_window_push(nullptr, 1.0f, 1.0f), POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_NO_THROW(polyfit_window_free(nullptr));
+}
+
+/*============================================================================*/
+/* MODEL BANK                                                                 */
+/*============================================================================*/
+
+TEST(PolyfitBank, SharedXMatchesScalarEvaluate) {
+    // 21 models of mixed degree cover every vector width plus a scalar tail
+    const int kModels = 21;
+    polyfit_bank_t *bank = polyfit_bank_create(kModels, 4);
+    ASSERT_NE(bank, nullptr);
+    Polynomial *polys[kModels];
+    for (int m = 0; m < kModels; m++) {
+        polys[m] = polyfit_init(m % 5);
+        ASSERT_NE(polys[m], nullptr);
+        for (int k = 0; k <= m % 5; k++) {
+            polys[m]->coefficients[k] = 0.1f * (float)(m + 1) - 0.3f * (float)k;
+        }
+        ASSERT_EQ(polyfit_bank_set(bank, m, polys[m]), POLYFIT_SUCCESS);
+    }
+
+    float out[kModels];
+    EXPECT_EQ(polyfit_bank_evaluate_shared(bank, 1.5f, out), POLYFIT_SUCCESS);
+    for (int m = 0; m < kModels; m++) {
+        float expected;
+        ASSERT_EQ(polyfit_evaluate(polys[m], 1.5f, &expected), POLYFIT_SUCCESS);
+        EXPECT_NEAR(out[m], expected, 1e-5f * (1.0f + std::fabs(expected)))
+            << "model " << m;
+        polyfit_free(polys[m]);
+    }
+    polyfit_bank_free(bank);
+}
+
+TEST(PolyfitBank, EachModelAtOwnX) {
+    Polynomial *lin = polyfit(kLinX, kLinY, kLinN, 1, nullptr);
+    Polynomial *quad = polyfit(kQuadX, kQuadY, kQuadN, 2, nullptr);
+    ASSERT_NE(lin, nullptr);
+    ASSERT_NE(quad, nullptr);
+    const Polynomial *polys[] = {lin, quad};
+
+    polyfit_bank_t *bank = polyfit_bank_create_from(polys, 2);
+    ASSERT_NE(bank, nullptr);
+    EXPECT_EQ(bank->max_degree, 2);
+
+    float xs[] = {3.0f, 4.0f};
+    float out[2];
+    EXPECT_EQ(polyfit_bank_evaluate_each(bank, xs, out), POLYFIT_SUCCESS);
+    EXPECT_NEAR(out[0], 7.0f, 1e-3f);
+    EXPECT_NEAR(out[1], 16.0f, 1e-3f);
+
+    polyfit_bank_free(bank);
+    polyfit_free(lin);
+    polyfit_free(quad);
+}
+
+TEST(PolyfitBank, SetCoefficientsFromArray) {
+    polyfit_bank_t *bank = polyfit_bank_create(1, 2);
+    ASSERT_NE(bank, nullptr);
+    float coeffs[] = {1.0f, 0.0f, 2.0f};
+    EXPECT_EQ(polyfit_bank_set_coefficients(bank, 0, coeffs, 2), POLYFIT_SUCCESS);
+    float out;
+    EXPECT_EQ(polyfit_bank_evaluate_shared(bank, 3.0f, &out), POLYFIT_SUCCESS);
+    EXPECT_NEAR(out, 19.0f, 1e-5f);
+    polyfit_bank_free(bank);
+}
+
+TEST(PolyfitBank, InvalidArguments) {
+    EXPECT_EQ(polyfit_bank_create(0, 2), nullptr);
+    EXPECT_EQ(polyfit_bank_create(4, POLYFIT_MAX_DEGREE + 1), nullptr);
+
+    polyfit_bank_t *bank = polyfit_bank_create(2, 1);
+    ASSERT_NE(bank, nullptr);
+    float coeffs[] = {1.0f, 2.0f, 3.0f};
+    EXPECT_EQ(polyfit_bank_set_coefficients(bank, 0, coeffs, 2),
+              POLYFIT_ERROR_INVALID_DEGREE);
+    EXPECT_EQ(polyfit_bank_set_coefficients(bank, 2, coeffs, 1),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_bank_evaluate_shared(bank, 1.0f, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+    polyfit_bank_free(bank);
+    EXPECT_NO_THROW(polyfit_bank_free(nullptr));
+}
+
+/*============================================================================*/
+/* PIECEWISE POLYNOMIALS                                                      */
+/*============================================================================*/
+
+TEST(PolyfitPiecewise, FixedBreakpointsRecoverEachPiece) {
+    // x^2 on [0, 1), 3 - 2x on [1, 2], sampled out of order
+    std::vector<float> x, y;
+    for (int i = 40; i >= 0; i--) {
+        const float xi = 0.05f * i;
+        x.push_back(xi);
+        y.push_back(xi < 1.0f ? xi * xi : 3.0f - 2.0f * xi);
+    }
+    const float knots[] = {0.0f, 1.0f, 2.0f};
+    polyfit_error_t err;
+    polyfit_piecewise_t *pw = polyfit_piecewise_fit(
+        x.data(), y.data(), (int32_t)x.size(), 2, knots, 2, false, &err);
+    ASSERT_NE(pw, nullptr);
+    EXPECT_EQ(err, POLYFIT_SUCCESS);
+
+    float v;
+    ASSERT_EQ(polyfit_piecewise_evaluate(pw, 0.5f, &v), POLYFIT_SUCCESS);
+    EXPECT_NEAR(v, 0.25f, 1e-4f);
+    ASSERT_EQ(polyfit_piecewise_evaluate(pw, 1.5f, &v), POLYFIT_SUCCESS);
+    EXPECT_NEAR(v, 0.0f, 1e-4f);
+    ASSERT_EQ(polyfit_piecewise_evaluate(pw, 2.5f, &v), POLYFIT_SUCCESS);
+    EXPECT_NEAR(v, -2.0f, 1e-3f);  // extrapolated from the last piece
+    polyfit_piecewise_free(pw);
+}
+
+TEST(PolyfitPiecewise, ContinuousPiecesMeetAtKnots) {
+    std::vector<float> x, y;
+    for (int i = 0; i <= 300; i++) {
+        x.push_back(0.01f * i);
+        y.push_back(std::sin(2.0f * x.back()) + 0.01f * std::sin(91.0f * i));
+    }
+    const float knots[] = {0.0f, 1.0f, 2.0f, 3.0f};
+    polyfit_piecewise_t *pw = polyfit_piecewise_fit(
+        x.data(), y.data(), (int32_t)x.size(), 2, knots, 3, true, nullptr);
+    ASSERT_NE(pw, nullptr);
+
+    for (int k = 1; k < 3; k++) {
+        float left, right;
+        const float before = std::nextafter(knots[k], 0.0f);
+        ASSERT_EQ(polyfit_piecewise_evaluate(pw, before, &left),
+                  POLYFIT_SUCCESS);
+        ASSERT_EQ(polyfit_piecewise_evaluate(pw, knots[k], &right),
+                  POLYFIT_SUCCESS);
+        EXPECT_EQ(polyfit_piecewise_segment(pw, before), k - 1);
+        EXPECT_EQ(polyfit_piecewise_segment(pw, knots[k]), k);
+        EXPECT_NEAR(left, right, 1e-4f);
+    }
+    polyfit_piecewise_free(pw);
+}
+
+TEST(PolyfitPiecewise, AutoBreakpointsMeetTarget) {
+    const int n = 2000;
+    std::vector<float> x(n), y(n), fitted(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = 10.0f * i / (n - 1);
+        y[i] = std::sin(x[i]) * std::exp(0.2f * x[i]);
+    }
+    const float target = 1e-3f;
+    for (bool continuous : {false, true}) {
+        polyfit_error_t err;
+        polyfit_piecewise_t *pw = polyfit_piecewise_fit_auto(
+            x.data(), y.data(), n, 3, target, 64, continuous, &err);
+        ASSERT_NE(pw, nullptr);
+        EXPECT_EQ(err, POLYFIT_SUCCESS);
+        EXPECT_GT(pw->num_segments, 1);
+        EXPECT_LT(pw->num_segments, 64);
+
+        ASSERT_EQ(polyfit_piecewise_evaluate_sorted(pw, x.data(),
+                                                    fitted.data(), n),
+                  POLYFIT_SUCCESS);
+        float worst = 0.0f;
+        for (int i = 0; i < n; i++) {
+            worst = std::max(worst, std::fabs(fitted[i] - y[i]));
+        }
+        EXPECT_LE(worst, 1.01f * target) << pw->num_segments;
+        polyfit_piecewise_free(pw);
+    }
+}
+
+TEST(PolyfitPiecewise, LookupMatchesLinearScan) {
+    const float knots[] = {-3.0f, -2.9f, 0.0f, 0.1f, 0.15f, 4.0f, 9.0f};
+    const int segments = 6;
+    std::vector<float> x, y;
+    for (int i = 0; i <= 1200; i++) {
+        x.push_back(-3.0f + 0.01f * i);
+        y.push_back(x.back());
+    }
+    polyfit_piecewise_t *pw = polyfit_piecewise_fit(
+        x.data(), y.data(), (int32_t)x.size(), 1, knots, segments, false,
+        nullptr);
+    ASSERT_NE(pw, nullptr);
+
+    std::vector<float> xs, batch, sorted;
+    for (int i = 0; i <= 1400; i++) xs.push_back(-4.0f + 0.01f * i);
+    for (float k : knots) xs.push_back(k);
+    for (float xi : xs) {
+        int expected = 0;
+        while (expected + 1 < segments && xi >= knots[expected + 1]) {
+            expected++;
+        }
+        EXPECT_EQ(polyfit_piecewise_segment(pw, xi), expected) << xi;
+    }
+
+    batch.resize(xs.size());
+    sorted.resize(xs.size());
+    ASSERT_EQ(polyfit_piecewise_evaluate_batch(pw, xs.data(), batch.data(),
+                                               (int32_t)xs.size()),
+              POLYFIT_SUCCESS);
+    // The appended knots step backwards, exercising the sorted fallback
+    ASSERT_EQ(polyfit_piecewise_evaluate_sorted(pw, xs.data(), sorted.data(),
+                                                (int32_t)xs.size()),
+              POLYFIT_SUCCESS);
+    for (size_t i = 0; i < xs.size(); i++) {
+        EXPECT_EQ(batch[i], sorted[i]);
+        EXPECT_NEAR(batch[i], xs[i], 1e-4f);
+    }
+    polyfit_piecewise_free(pw);
+}
+
+TEST(PolyfitPiecewise, InvalidArguments) {
+    const float descending[] = {1.0f, 0.0f};
+    const float empty_middle[] = {0.0f, 1.0f, 5.0f, 6.0f};
+    polyfit_error_t err;
+    EXPECT_EQ(polyfit_piecewise_fit(kLinX, kLinY, kLinN, 1, descending, 1,
+                                    false, &err),
+              nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_piecewise_fit(kLinX, kLinY, kLinN, 1, empty_middle, 3,
+                                    false, &err),
+              nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INSUFFICIENT_POINTS);
+
+    const float unsorted[] = {0.0f, 2.0f, 1.0f, 3.0f};
+    EXPECT_EQ(polyfit_piecewise_fit_auto(unsorted, unsorted, 4, 1, 0.1f, 4,
+                                         false, &err),
+              nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_piecewise_fit_auto(nullptr, unsorted, 4, 1, 0.1f, 4,
+                                         false, &err),
+              nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_piecewise_segment(nullptr, 0.0f), -1);
+    EXPECT_NO_THROW(polyfit_piecewise_free(nullptr));
+}
+
+/*============================================================================*/
+/* FIT PLANS                                                                  */
+/*============================================================================*/
+
+TEST(PolyfitPlan, ExecuteMatchesLeastSquares) {
+    polyfit_error_t err;
+    polyfit_plan_t *plan = polyfit_plan_create(kQuadX, kQuadN, 2, &err);
+    ASSERT_NE(plan, nullptr);
+    EXPECT_EQ(err, POLYFIT_SUCCESS);
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_plan_execute(plan, kQuadY, p), POLYFIT_SUCCESS);
+    EXPECT_TRUE(p->is_normalized);
+    for (int i = 0; i < kQuadN; i++) {
+        float value;
+        polyfit_evaluate(p, kQuadX[i], &value);
+        EXPECT_NEAR(value, kQuadY[i], 1e-4f);
+    }
+
+    polyfit_free(p);
+    polyfit_plan_free(plan);
+}
+
+TEST(PolyfitPlan, BatchMatchesPerSeriesFits) {
+    // Six series (a block of four plus two) of y = a + b*x on the same grid
+    const int kSeries = 6;
+    float ys[kSeries * kLinN];
+    for (int s = 0; s < kSeries; s++) {
+        for (int i = 0; i < kLinN; i++) {
+            ys[s * kLinN + i] = (float)s + (float)(s - 2) * kLinX[i];
+        }
+    }
+
+    polyfit_plan_t *plan = polyfit_plan_create(kLinX, kLinN, 1, nullptr);
+    ASSERT_NE(plan, nullptr);
+    float coeffs[kSeries * 2];
+    EXPECT_EQ(polyfit_plan_execute_batch(plan, ys, kSeries, coeffs),
+              POLYFIT_SUCCESS);
+    // Coefficients are in t = (x - x_offset) * x_scale
+    for (int s = 0; s < kSeries; s++) {
+        const float intercept = (float)s + (float)(s - 2) * plan->x_offset;
+        const float slope = (float)(s - 2) / plan->x_scale;
+        EXPECT_NEAR(coeffs[s * 2 + 0], intercept, 1e-4f) << "series " << s;
+        EXPECT_NEAR(coeffs[s * 2 + 1], slope, 1e-4f) << "series " << s;
+    }
+    polyfit_plan_free(plan);
+}
+
+TEST(PolyfitPlan, WideGridMatchesLeastSquaresAtHighDegree) {
+    // Fixed sampling times over [0, 100], where raw powers reach 1e12
+    const int n = 200;
+    std::vector<float> x(n), y(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = 100.0f * (float)i / (float)(n - 1);
+        y[i] = 5.0f + 20.0f * std::sin(x[i] / 15.0f) +
+               0.05f * std::cos(7.0f * (float)i);
+    }
+
+    for (int degree = 5; degree <= 8; degree++) {
+        polyfit_plan_t *plan = polyfit_plan_create(x.data(), n, degree,
+                                                   nullptr);
+        ASSERT_NE(plan, nullptr);
+        Polynomial *planned = polyfit_init(degree);
+        Polynomial *direct = polyfit_init(degree);
+        ASSERT_EQ(polyfit_plan_execute(plan, y.data(), planned),
+                  POLYFIT_SUCCESS);
+        ASSERT_EQ(polyfit_least_squares(x.data(), y.data(), n, degree,
+                                        direct),
+                  POLYFIT_SUCCESS);
+
+        float r2_planned, r2_direct;
+        ASSERT_EQ(polyfit_r_squared(planned, x.data(), y.data(), n,
+                                    &r2_planned),
+                  POLYFIT_SUCCESS);
+        ASSERT_EQ(polyfit_r_squared(direct, x.data(), y.data(), n,
+                                    &r2_direct),
+                  POLYFIT_SUCCESS);
+        EXPECT_GT(r2_planned, 0.99f) << "degree " << degree;
+        EXPECT_GE(r2_planned, r2_direct - 1e-4f) << "degree " << degree;
+
+        // Pointwise, the plan matches the normalized-domain fit
+        polyfit_config_t config = polyfit_default_config();
+        config.normalize_domain = true;
+        Polynomial *normalized = polyfit_init(degree);
+        ASSERT_EQ(polyfit_least_squares_ex(x.data(), y.data(), n, degree,
+                                           &config, normalized),
+                  POLYFIT_SUCCESS);
+        for (int i = 0; i < n; i += 13) {
+            float a, b;
+            polyfit_evaluate(planned, x[i], &a);
+            polyfit_evaluate(normalized, x[i], &b);
+            EXPECT_NEAR(a, b, 1e-3f) << "degree " << degree << " x " << x[i];
+        }
+
+        polyfit_free(normalized);
+        polyfit_free(direct);
+        polyfit_free(planned);
+        polyfit_plan_free(plan);
+    }
+}
+
+TEST(PolyfitPlan, NonFiniteYRejected) {
+    polyfit_plan_t *plan = polyfit_plan_create(kLinX, kLinN, 1, nullptr);
+    ASSERT_NE(plan, nullptr);
+    float yi[] = {1.0f, 2.0f, 0.0f / 0.0f, 4.0f, 5.0f};
+    Polynomial *p = polyfit_init(1);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_plan_execute(plan, yi, p), POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_free(p);
+    polyfit_plan_free(plan);
+}
+
+TEST(PolyfitPlan, CreateErrors) {
+    polyfit_error_t err;
+    EXPECT_EQ(polyfit_plan_create(nullptr, kLinN, 1, &err), nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_plan_create(kLinX, 2, 2, &err), nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INSUFFICIENT_POINTS);
+    EXPECT_EQ(polyfit_plan_create(kLinX, kLinN, -1, &err), nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_INVALID_DEGREE);
+    // Three distinct points cannot determine a cubic
+    const float repeated[] = {1.0f, 1.0f, 2.0f, 2.0f, 3.0f};
+    EXPECT_EQ(polyfit_plan_create(repeated, 5, 3, &err), nullptr);
+    EXPECT_EQ(err, POLYFIT_ERROR_SINGULAR_MATRIX);
+    EXPECT_NO_THROW(polyfit_plan_free(nullptr));
+}
+
+/*============================================================================*/
+/* ORTHOGONAL POLYNOMIALS                                                     */
+/*============================================================================*/
+
+TEST(PolyfitOrthogonal, MatchesLeastSquaresFit) {
+    polyfit_orthogonal_t ortho;
+    ASSERT_EQ(polyfit_orthogonal_fit(kQuadX, kQuadY, kQuadN, 2, &ortho),
+              POLYFIT_SUCCESS);
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(polyfit_orthogonal_to_polynomial(&ortho, 2, p), POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_denormalize(p), POLYFIT_SUCCESS);
+    EXPECT_NEAR(p->coefficients[0], 0.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[1], 0.0f, 1e-4f);
+    EXPECT_NEAR(p->coefficients[2], 1.0f, 1e-4f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitOrthogonal, TruncationGivesLowerDegreeFit) {
+    polyfit_orthogonal_t ortho;
+    ASSERT_EQ(polyfit_orthogonal_fit(kQuadX, kQuadY, kQuadN, 4, &ortho),
+              POLYFIT_SUCCESS);
+
+    Polynomial *truncated = polyfit_init(1);
+    Polynomial *direct = polyfit(kQuadX, kQuadY, kQuadN, 1, nullptr);
+    ASSERT_NE(truncated, nullptr);
+    ASSERT_NE(direct, nullptr);
+    EXPECT_EQ(polyfit_orthogonal_to_polynomial(&ortho, 1, truncated),
+              POLYFIT_SUCCESS);
+    for (float x = -3.0f; x <= 5.0f; x += 1.0f) {
+        float a, b;
+        polyfit_evaluate(truncated, x, &a);
+        polyfit_evaluate(direct, x, &b);
+        EXPECT_NEAR(a, b, 1e-4f) << "x = " << x;
+    }
+    polyfit_free(truncated);
+    polyfit_free(direct);
+}
+
+TEST(PolyfitOrthogonal, ResidualPerDegree) {
+    polyfit_orthogonal_t ortho;
+    ASSERT_EQ(polyfit_orthogonal_fit(kQuadX, kQuadY, kQuadN, 3, &ortho),
+              POLYFIT_SUCCESS);
+    EXPECT_GT(ortho.rss[0], ortho.rss[1]);
+    EXPECT_GT(ortho.rss[1], 1.0f);                   // a line misses y = x^2
+    EXPECT_NEAR(ortho.rss[2], 0.0f, 1e-3f);          // a parabola does not
+    EXPECT_LE(ortho.rss[3], ortho.rss[2] + 1e-6f);
+}
+
+TEST(PolyfitOrthogonal, ClenshawMatchesMonomialEvaluation) {
+    polyfit_orthogonal_t ortho;
+    ASSERT_EQ(polyfit_orthogonal_fit(kLinX, kLinY, kLinN, 3, &ortho),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(3);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(polyfit_orthogonal_to_polynomial(&ortho, 3, p), POLYFIT_SUCCESS);
+    for (float x = -1.0f; x <= 6.0f; x += 0.5f) {
+        float clenshaw, horner;
+        EXPECT_EQ(polyfit_orthogonal_evaluate(&ortho, x, &clenshaw),
+                  POLYFIT_SUCCESS);
+        polyfit_evaluate(p, x, &horner);
+        EXPECT_NEAR(clenshaw, horner, 1e-4f) << "x = " << x;
+        EXPECT_NEAR(clenshaw, 2.0f * x + 1.0f, 1e-3f) << "x = " << x;
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitOrthogonal, InvalidInputs) {
+    polyfit_orthogonal_t ortho;
+    float xi[] = {1.0f, 1.0f, 1.0f};
+    float yi[] = {1.0f, 2.0f, 3.0f};
+    // All x equal: only a constant can be fitted
+    EXPECT_EQ(polyfit_orthogonal_fit(xi, yi, 3, 1, &ortho),
+              POLYFIT_ERROR_SINGULAR_MATRIX);
+    EXPECT_EQ(polyfit_orthogonal_fit(kLinX, kLinY, 2, 2, &ortho),
+              POLYFIT_ERROR_INSUFFICIENT_POINTS);
+    EXPECT_EQ(polyfit_orthogonal_fit(nullptr, kLinY, kLinN, 1, &ortho),
+              POLYFIT_ERROR_NULL_POINTER);
+}
+
+/*============================================================================*/
+/* WORKSPACE AND ALLOCATOR                                                    */
+/*============================================================================*/
+
+struct CountingAllocator {
+    int allocs = 0;
+    int frees = 0;
+};
+
+static void *counting_alloc(size_t size, void *user_data) {
+    static_cast<CountingAllocator *>(user_data)->allocs++;
+    return std::malloc(size);
+}
+
+static void counting_free(void *ptr, void *user_data) {
+    static_cast<CountingAllocator *>(user_data)->frees++;
+    std::free(ptr);
+}
+
+TEST(PolyfitWorkspace, FitMatchesLeastSquares) {
+    polyfit_workspace_t *ws = polyfit_workspace_create(4, nullptr);
+    ASSERT_NE(ws, nullptr);
+    Polynomial *a = polyfit_init(2);
+    Polynomial *b = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares(kQuadX, kQuadY, kQuadN, 2, a),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares_ws(kQuadX, kQuadY, kQuadN, 2, nullptr, ws,
+                                       b),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_FLOAT_EQ(a->coefficients[i], b->coefficients[i]);
+    }
+
+    // The moments stay in the workspace for a cheaper lower-degree solve
+    Polynomial *line = polyfit_init(1);
+    EXPECT_EQ(polyfit_fit_moments_ws(&ws->moments, 1, ws, line),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_fit_moments_ws(&ws->moments, 3, ws, line),
+              POLYFIT_ERROR_INVALID_DEGREE);
+
+    polyfit_free(a);
+    polyfit_free(b);
+    polyfit_free(line);
+    polyfit_workspace_free(ws);
+}
+
+TEST(PolyfitWorkspace, EveryFitEntryPointHasAWorkspaceVariant) {
+    polyfit_workspace_t *ws = polyfit_workspace_create(3, nullptr);
+    ASSERT_NE(ws, nullptr);
+    Polynomial *a = polyfit_init(2);
+    Polynomial *b = polyfit_init(2);
+    const float w[] = {1.0f, 2.0f, 0.5f, 1.0f, 3.0f, 1.0f, 2.0f, 1.0f, 1.0f};
+
+    ASSERT_EQ(polyfit_least_squares_weighted(kQuadX, kQuadY, w, kQuadN, 2,
+                                             nullptr, a),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares_weighted_ws(kQuadX, kQuadY, w, kQuadN, 2,
+                                                nullptr, ws, b),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_FLOAT_EQ(a->coefficients[i], b->coefficients[i]);
+    }
+
+    const polyfit_input_t x_in = polyfit_input(kQuadX, POLYFIT_TYPE_FLOAT);
+    const polyfit_input_t y_in = polyfit_input(kQuadY, POLYFIT_TYPE_FLOAT);
+    ASSERT_EQ(polyfit_least_squares_typed(&x_in, &y_in, kQuadN, 2, nullptr, a),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares_typed_ws(&x_in, &y_in, kQuadN, 2, nullptr,
+                                             ws, b),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_FLOAT_EQ(a->coefficients[i], b->coefficients[i]);
+    }
+
+    polyfit_quality_t qa, qb;
+    ASSERT_EQ(polyfit_least_squares_quality(kQuadX, kQuadY, kQuadN, 2, nullptr,
+                                            a, &qa),
+              POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares_quality_ws(kQuadX, kQuadY, kQuadN, 2,
+                                               nullptr, ws, b, &qb),
+              POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(qa.r_squared, qb.r_squared);
+    EXPECT_EQ(qa.dof, qb.dof);
+
+    EXPECT_EQ(polyfit_least_squares_weighted_ws(kQuadX, kQuadY, w, kQuadN, 2,
+                                                nullptr, nullptr, b),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_least_squares_quality_ws(kQuadX, kQuadY, kQuadN, 2,
+                                               nullptr, ws, b, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_least_squares_typed_ws(&x_in, &y_in, kQuadN, 4, nullptr,
+                                             ws, b),
+              POLYFIT_ERROR_INVALID_DEGREE);
+
+    polyfit_free(a);
+    polyfit_free(b);
+    polyfit_workspace_free(ws);
+}
+
+TEST(PolyfitWorkspace, FitPathMakesNoAllocations) {
+    CountingAllocator counter;
+    polyfit_allocator_t allocator = {counting_alloc, counting_free, &counter};
+    ASSERT_EQ(polyfit_set_allocator(&allocator), POLYFIT_SUCCESS);
+
+    polyfit_workspace_t *ws = polyfit_workspace_create(3, nullptr);
+    Polynomial *p = polyfit_init(3);
+    ASSERT_NE(ws, nullptr);
+    ASSERT_NE(p, nullptr);
+    const int setup_allocs = counter.allocs;
+    EXPECT_GT(setup_allocs, 0);
+
+    polyfit_config_t config = polyfit_default_config();
+    for (int i = 0; i < 100; i++) {
+        config.normalize_domain = (i % 2 == 0);
+        ASSERT_EQ(polyfit_least_squares_ws(kQuadX, kQuadY, kQuadN, 3, &config,
+                                           ws, p),
+                  POLYFIT_SUCCESS);
+        ASSERT_EQ(polyfit_least_squares(kQuadX, kQuadY, kQuadN, 3, p),
+                  POLYFIT_SUCCESS);
+    }
+    EXPECT_EQ(counter.allocs, setup_allocs);
+
+    polyfit_free(p);
+    polyfit_workspace_free(ws);
+    EXPECT_EQ(counter.frees, counter.allocs);
+    EXPECT_EQ(polyfit_set_allocator(nullptr), POLYFIT_SUCCESS);
+}
+
+TEST(PolyfitWorkspace, InitOverCallerBuffer) {
+    float buffer[POLYFIT_WORKSPACE_FLOATS(2)];
+    polyfit_workspace_t ws;
+    EXPECT_EQ(polyfit_workspace_init(&ws, buffer, 3, 2),
+              POLYFIT_ERROR_INVALID_INPUT);
+    ASSERT_EQ(polyfit_workspace_init(&ws, buffer, POLYFIT_WORKSPACE_FLOATS(2),
+                                     2),
+              POLYFIT_SUCCESS);
+
+    float coeffs[4];
+    Polynomial p = {};
+    p.coefficients = coeffs;
+    p.degree = 3;
+    EXPECT_EQ(polyfit_least_squares_ws(kQuadX, kQuadY, kQuadN, 3, nullptr,
+                                       &ws, &p),
+              POLYFIT_ERROR_INVALID_DEGREE);
+    ASSERT_EQ(polyfit_least_squares_ws(kQuadX, kQuadY, kQuadN, 2, nullptr,
+                                       &ws, &p),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(p.coefficients[2], 1.0f, 1e-4f);
+}
+
+TEST(PolyfitWorkspace, PerCallAllocatorUsedForParallelBlocks) {
+    CountingAllocator counter;
+    polyfit_allocator_t allocator = {counting_alloc, counting_free, &counter};
+    polyfit_config_t config = polyfit_default_config();
+    config.num_threads = 2;
+    config.allocator = &allocator;
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_ex(kQuadX, kQuadY, kQuadN, 2, &config, p),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(counter.allocs, 1);
+    EXPECT_EQ(counter.frees, 1);
+    polyfit_free(p);
+}
+
+TEST(PolyfitWorkspace, RejectsIncompleteAllocator) {
+    polyfit_allocator_t allocator = {counting_alloc, nullptr, nullptr};
+    EXPECT_EQ(polyfit_set_allocator(&allocator), POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_workspace_create(2, &allocator), nullptr);
+    EXPECT_EQ(polyfit_workspace_create(POLYFIT_MAX_DEGREE + 1, nullptr),
+              nullptr);
+}
+
+/*============================================================================*/
+/* STATIC POLYNOMIALS                                                         */
+/*============================================================================*/
+
+TEST(PolyfitStatic, OneCacheLine) {
+    EXPECT_EQ(sizeof(polyfit_static_poly_t), 64u);
+    EXPECT_EQ(alignof(polyfit_static_poly_t), 64u);
+}
+
+TEST(PolyfitStatic, FitMatchesHeapPolynomial) {
+    polyfit_static_poly_t sp;
+    ASSERT_EQ(polyfit_static_fit(kQuadX, kQuadY, kQuadN, 2, nullptr, &sp),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit(kQuadX, kQuadY, kQuadN, 2, nullptr);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(sp.degree, 2);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_FLOAT_EQ(sp.coefficients[i], p->coefficients[i]);
+    }
+
+    float a, b;
+    ASSERT_EQ(polyfit_static_evaluate(&sp, 1.5f, &a), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_evaluate(p, 1.5f, &b), POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(a, b);
+    polyfit_free(p);
+}
+
+TEST(PolyfitStatic, NormalizedFitEvaluates) {
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    polyfit_static_poly_t sp;
+    ASSERT_EQ(polyfit_static_fit(kLinX, kLinY, kLinN, 1, &config, &sp),
+              POLYFIT_SUCCESS);
+    EXPECT_TRUE(sp.is_normalized);
+
+    float xs[] = {0.0f, 2.5f, 10.0f};
+    float out[3];
+    ASSERT_EQ(polyfit_static_evaluate_batch(&sp, xs, out, 3), POLYFIT_SUCCESS);
+    EXPECT_NEAR(out[0], 1.0f, 1e-4f);
+    EXPECT_NEAR(out[1], 6.0f, 1e-4f);
+    EXPECT_NEAR(out[2], 21.0f, 1e-3f);
+}
+
+TEST(PolyfitStatic, ViewAndCopyInteroperate) {
+    polyfit_static_poly_t sp;
+    ASSERT_EQ(polyfit_static_fit(kLinX, kLinY, kLinN, 1, nullptr, &sp),
+              POLYFIT_SUCCESS);
+    Polynomial view = polyfit_static_view(&sp);
+    float r2 = 0.0f;
+    EXPECT_EQ(polyfit_r_squared(&view, kLinX, kLinY, kLinN, &r2),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(r2, 1.0f, 1e-5f);
+
+    Polynomial *p = polyfit(kQuadX, kQuadY, kQuadN, 2, nullptr);
+    polyfit_static_poly_t copy;
+    ASSERT_EQ(polyfit_static_from_polynomial(&copy, p), POLYFIT_SUCCESS);
+    float coeffs[3];
+    EXPECT_EQ(polyfit_static_get_coefficients(&copy, coeffs, 2),
+              POLYFIT_ERROR_INVALID_INPUT);
+    ASSERT_EQ(polyfit_static_get_coefficients(&copy, coeffs, 3),
+              POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(coeffs[2], p->coefficients[2]);
+    polyfit_free(p);
+}
+
+TEST(PolyfitStatic, ZeroInitializedIsInvalid) {
+    polyfit_static_poly_t sp = {};
+    float result;
+    EXPECT_EQ(polyfit_static_evaluate(&sp, 1.0f, &result),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_static_init(&sp, POLYFIT_MAX_DEGREE + 1),
+              POLYFIT_ERROR_INVALID_DEGREE);
+    ASSERT_EQ(polyfit_static_init(&sp, 3), POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_static_evaluate(&sp, 1.0f, &result), POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(result, 0.0f);
+}
+
+/*============================================================================*/
+/* FIXED-POINT EVALUATION                                                     */
+/*============================================================================*/
+
+// Largest |fixed - exact| over every integer input, in real units. The
+// reference evaluates the float coefficients in double, which is what the
+// error bound is stated against.
+static double fixed_max_deviation(const Polynomial *p,
+                                  const polyfit_fixed_t &fx, int32_t lo,
+                                  int32_t hi) {
+    double worst = 0.0;
+    for (int32_t xq = lo; xq <= hi; xq++) {
+        double t = std::ldexp((double)xq, -fx.input_frac_bits);
+        if (p->is_normalized) {
+            t = (t - p->x_offset) * p->x_scale;
+        }
+        double expected = 0.0;
+        for (int k = p->degree; k >= 0; k--) {
+            expected = expected * t + p->coefficients[k];
+        }
+        const double got =
+            std::ldexp((double)polyfit_fixed_evaluate(&fx, xq),
+                       -fx.frac_bits[0]);
+        worst = std::max(worst, std::fabs(got - expected));
+    }
+    return worst;
+}
+
+TEST(PolyfitFixed, RawAdcCodesWithinBound) {
+    // Cubic sensor curve over 12-bit ADC codes
+    std::vector<float> x, y;
+    for (int i = 0; i < 4096; i += 64) {
+        x.push_back((float)i);
+        y.push_back(-40.0f + 0.05f * i - 4e-6f * i * i + 5e-10f * i * i * i);
+    }
+    Polynomial *p = polyfit_init(3);
+    ASSERT_EQ(polyfit_least_squares(x.data(), y.data(), (int32_t)x.size(), 3,
+                                    p),
+              POLYFIT_SUCCESS);
+
+    polyfit_fixed_t fx;
+    ASSERT_EQ(polyfit_fixed_from_polynomial(p, 0.0f, 4095.0f, 0, &fx),
+              POLYFIT_SUCCESS);
+    EXPECT_GT(fx.error_bound, 0.0f);
+    EXPECT_LT(fx.error_bound, 1e-3f);
+    EXPECT_LE(fixed_max_deviation(p, fx, 0, 4095), fx.error_bound);
+    polyfit_free(p);
+}
+
+TEST(PolyfitFixed, NormalizedFractionalInputWithinBound) {
+    std::vector<float> x, y;
+    for (int i = 0; i <= 200; i++) {
+        x.push_back(-2.0f + 0.02f * i);
+        y.push_back(std::sin(x.back()) * 100.0f);
+    }
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    Polynomial *p = polyfit_init(7);
+    ASSERT_EQ(polyfit_least_squares_ex(x.data(), y.data(), (int32_t)x.size(),
+                                       7, &config, p),
+              POLYFIT_SUCCESS);
+    ASSERT_TRUE(p->is_normalized);
+
+    polyfit_fixed_t fx;
+    ASSERT_EQ(polyfit_fixed_from_polynomial(p, -2.0f, 2.0f, 16, &fx),
+              POLYFIT_SUCCESS);
+    EXPECT_LT(fx.error_bound, 1e-3f);
+    const int32_t lo = -(2 << 16);
+    const int32_t hi = 2 << 16;
+    EXPECT_LE(fixed_max_deviation(p, fx, lo, hi), fx.error_bound);
+
+    // Inputs beyond the range clamp to its ends
+    EXPECT_EQ(polyfit_fixed_evaluate(&fx, hi + 1000),
+              polyfit_fixed_evaluate(&fx, hi));
+
+    std::vector<int32_t> xs = {lo, 0, hi}, out(3);
+    ASSERT_EQ(polyfit_fixed_evaluate_batch(&fx, xs.data(), out.data(), 3),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(out[1], polyfit_fixed_evaluate(&fx, 0));
+    polyfit_free(p);
+}
+
+TEST(PolyfitFixed, InvalidArguments) {
+    Polynomial *p = polyfit_init(2);
+    polyfit_fixed_t fx;
+    EXPECT_EQ(polyfit_fixed_from_polynomial(nullptr, 0.0f, 1.0f, 0, &fx),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_fixed_from_polynomial(p, 1.0f, 1.0f, 0, &fx),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_EQ(polyfit_fixed_from_polynomial(p, 0.0f, 1.0f, 31, &fx),
+              POLYFIT_ERROR_INVALID_INPUT);
+    // 1e6 in Q16 does not fit 32 bits
+    EXPECT_EQ(polyfit_fixed_from_polynomial(p, 0.0f, 1e6f, 16, &fx),
+              POLYFIT_ERROR_INVALID_INPUT);
+    p->coefficients[2] = 1e30f;
+    EXPECT_EQ(polyfit_fixed_from_polynomial(p, 0.0f, 1e6f, 0, &fx),
+              POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_free(p);
+}
+
+/*============================================================================*/
+/* INVERSE EVALUATION                                                         */
+/*============================================================================*/
+
+TEST(PolyfitInverse, SolvesMonotonicCubic) {
+    // p(x) = 1 + x + x^3
+    Polynomial *p = polyfit_init(3);
+    p->coefficients[0] = 1.0f;
+    p->coefficients[1] = 1.0f;
+    p->coefficients[3] = 1.0f;
+    p->is_valid = true;
+
+    for (float expected : {-1.9f, -0.5f, 0.0f, 0.3f, 1.7f}) {
+        const float y = 1.0f + expected + expected * expected * expected;
+        float x = 0.0f;
+        ASSERT_EQ(polyfit_inverse(p, y, -2.0f, 2.0f, &x), POLYFIT_SUCCESS);
+        EXPECT_NEAR(x, expected, 1e-5f);
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitInverse, NormalizedCalibrationCurve) {
+    // Decreasing sensor curve fitted on a normalized domain
+    std::vector<float> x, y;
+    for (int i = 0; i <= 100; i++) {
+        x.push_back(100.0f + 2.0f * i);
+        y.push_back(std::exp(-x.back() / 150.0f) * 50.0f);
+    }
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    Polynomial *p = polyfit_init(5);
+    ASSERT_EQ(polyfit_least_squares_ex(x.data(), y.data(), (int32_t)x.size(),
+                                       5, &config, p),
+              POLYFIT_SUCCESS);
+
+    for (float target : {120.0f, 187.5f, 299.0f}) {
+        float value;
+        polyfit_evaluate(p, target, &value);
+        float solved;
+        ASSERT_EQ(polyfit_inverse(p, value, 100.0f, 300.0f, &solved),
+                  POLYFIT_SUCCESS);
+        EXPECT_NEAR(solved, target, 1e-2f);
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitInverse, BatchMatchesScalar) {
+    Polynomial *p = polyfit_init(2);
+    p->coefficients[1] = 2.0f;
+    p->coefficients[2] = 0.5f;  // increasing on [0, 4]
+    p->is_valid = true;
+
+    std::vector<float> ys, xs(41);
+    for (int i = 0; i <= 40; i++) {
+        ys.push_back(0.4f * i);
+    }
+    ASSERT_EQ(polyfit_inverse_batch(p, ys.data(), xs.data(), 41, 0.0f, 4.0f),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i <= 40; i++) {
+        float x;
+        ASSERT_EQ(polyfit_inverse(p, ys[i], 0.0f, 4.0f, &x), POLYFIT_SUCCESS);
+        EXPECT_NEAR(xs[i], x, 1e-6f);
+    }
+
+    // Unreachable targets give NaN but the others are still solved
+    std::vector<float> mixed = {1.0f, 100.0f, 2.0f}, out(3);
+    EXPECT_EQ(polyfit_inverse_batch(p, mixed.data(), out.data(), 3, 0.0f, 4.0f),
+              POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_TRUE(std::isnan(out[1]));
+    EXPECT_NEAR(2.0f * out[2] + 0.5f * out[2] * out[2], 2.0f, 1e-5f);
+    polyfit_free(p);
+}
+
+TEST(PolyfitInverse, InversePolynomialApproximation) {
+    Polynomial *p = polyfit_init(3);
+    p->coefficients[0] = 1.0f;
+    p->coefficients[1] = 1.0f;
+    p->coefficients[3] = 0.2f;
+    p->is_valid = true;
+
+    float max_error = -1.0f;
+    polyfit_error_t error;
+    Polynomial *inverse =
+        polyfit_inverse_polynomial(p, -1.0f, 2.0f, 7, &max_error, &error);
+    ASSERT_NE(inverse, nullptr);
+    EXPECT_EQ(error, POLYFIT_SUCCESS);
+    EXPECT_GE(max_error, 0.0f);
+    EXPECT_LT(max_error, 2e-2f);
+
+    // The reported error bounds the round trip across the range
+    for (float x : {-1.0f, 0.5f, 2.0f}) {
+        float y, back;
+        polyfit_evaluate(p, x, &y);
+        polyfit_evaluate(inverse, y, &back);
+        EXPECT_LE(std::fabs(back - x), max_error + 1e-5f);
+    }
+    polyfit_free(inverse);
+
+    // A turning point makes the inverse multi-valued
+    EXPECT_EQ(polyfit_inverse_polynomial(p, -1.0f, 2.0f, 0, nullptr, &error),
+              nullptr);
+    EXPECT_EQ(error, POLYFIT_ERROR_INVALID_DEGREE);
+    p->coefficients[1] = -1.0f;
+    EXPECT_EQ(polyfit_inverse_polynomial(p, -2.0f, 2.0f, 5, nullptr, &error),
+              nullptr);
+    EXPECT_EQ(error, POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_free(p);
+}
+
+TEST(PolyfitInverse, InvalidArguments) {
+    Polynomial *p = polyfit_init(1);
+    p->coefficients[1] = 1.0f;
+    p->is_valid = true;
+    float x;
+    EXPECT_EQ(polyfit_inverse(nullptr, 0.5f, 0.0f, 1.0f, &x),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_inverse(p, 0.5f, 0.0f, 1.0f, nullptr),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_inverse(p, 0.5f, 1.0f, 0.0f, &x),
+              POLYFIT_ERROR_INVALID_INPUT);
+    // Not bracketed by the interval
+    EXPECT_EQ(polyfit_inverse(p, 5.0f, 0.0f, 1.0f, &x),
+              POLYFIT_ERROR_INVALID_INPUT);
+    // Roots at the ends are accepted
+    ASSERT_EQ(polyfit_inverse(p, 1.0f, 0.0f, 1.0f, &x), POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(x, 1.0f);
+    polyfit_free(p);
+}
+
+/*============================================================================*/
+/* CALCULUS                                                                   */
+/*============================================================================*/
+
+TEST(PolyfitCalculus, DerivativeAndAntiderivativeCoefficients) {
+    // p(x) = 2 - 3x + x^2 + 4x^3
+    Polynomial *p = polyfit_init(3);
+    const float c[] = {2.0f, -3.0f, 1.0f, 4.0f};
+    std::copy(c, c + 4, p->coefficients);
+
+    polyfit_error_t error;
+    Polynomial *d = polyfit_derivative(p, &error);
+    ASSERT_NE(d, nullptr);
+    EXPECT_EQ(error, POLYFIT_SUCCESS);
+    ASSERT_EQ(d->degree, 2);
+    EXPECT_FLOAT_EQ(d->coefficients[0], -3.0f);
+    EXPECT_FLOAT_EQ(d->coefficients[1], 2.0f);
+    EXPECT_FLOAT_EQ(d->coefficients[2], 12.0f);
+
+    Polynomial *a = polyfit_antiderivative(p, &error);
+    ASSERT_NE(a, nullptr);
+    ASSERT_EQ(a->degree, 4);
+    EXPECT_FLOAT_EQ(a->coefficients[0], 0.0f);
+    EXPECT_FLOAT_EQ(a->coefficients[1], 2.0f);
+    EXPECT_FLOAT_EQ(a->coefficients[2], -1.5f);
+    EXPECT_FLOAT_EQ(a->coefficients[4], 1.0f);
+
+    // Differentiating the antiderivative gives p back
+    Polynomial *back = polyfit_derivative(a, nullptr);
+    ASSERT_NE(back, nullptr);
+    for (int k = 0; k <= 3; k++) {
+        EXPECT_FLOAT_EQ(back->coefficients[k], c[k]);
+    }
+
+    // A constant differentiates to zero
+    Polynomial *constant = polyfit_init(0);
+    constant->coefficients[0] = 5.0f;
+    Polynomial *zero = polyfit_derivative(constant, nullptr);
+    ASSERT_NE(zero, nullptr);
+    EXPECT_EQ(zero->degree, 0);
+    EXPECT_EQ(zero->coefficients[0], 0.0f);
+
+    polyfit_free(zero);
+    polyfit_free(constant);
+    polyfit_free(back);
+    polyfit_free(a);
+    polyfit_free(d);
+    polyfit_free(p);
+}
+
+TEST(PolyfitCalculus, NormalizedDomainUsesChainRule) {
+    std::vector<float> x, y;
+    for (int i = 0; i <= 100; i++) {
+        x.push_back(1000.0f + 0.5f * i);
+        const double u = x.back() - 1000.0;
+        y.push_back((float)(3.0 + 0.2 * u - 0.01 * u * u));
+    }
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    Polynomial *p = polyfit_init(2);
+    ASSERT_EQ(polyfit_least_squares_ex(x.data(), y.data(), (int32_t)x.size(),
+                                       2, &config, p),
+              POLYFIT_SUCCESS);
+    ASSERT_TRUE(p->is_normalized);
+
+    Polynomial *d = polyfit_derivative(p, nullptr);
+    ASSERT_NE(d, nullptr);
+    EXPECT_TRUE(d->is_normalized);
+    float slope, value, first, second;
+    polyfit_evaluate(d, 1020.0f, &slope);
+    EXPECT_NEAR(slope, 0.2f - 0.02f * 20.0f, 1e-3f);
+
+    ASSERT_EQ(polyfit_evaluate_derivatives(p, 1020.0f, &value, &first,
+                                           &second),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(value, 3.0f + 4.0f - 4.0f, 1e-3f);
+    EXPECT_NEAR(first, slope, 1e-4f);
+    EXPECT_NEAR(second, -0.02f, 1e-4f);
+
+    // Integral of 3 + 0.2u - 0.01u^2 over u in [0, 30]
+    const float expected = 90.0f + 0.1f * 900.0f - 0.01f * 9000.0f;
+    float integral;
+    ASSERT_EQ(polyfit_integrate(p, 1000.0f, 1030.0f, &integral),
+              POLYFIT_SUCCESS);
+    EXPECT_NEAR(integral, expected, 1e-2f);
+
+    Polynomial *a = polyfit_antiderivative(p, nullptr);
+    ASSERT_NE(a, nullptr);
+    float fa, fb;
+    polyfit_evaluate(a, 1000.0f, &fa);
+    polyfit_evaluate(a, 1030.0f, &fb);
+    EXPECT_NEAR(fb - fa, expected, 1e-2f);
+
+    polyfit_free(a);
+    polyfit_free(d);
+    polyfit_free(p);
+}
+
+TEST(PolyfitCalculus, BatchDerivativesMatchScalar) {
+    Polynomial *p = polyfit_init(POLYFIT_MAX_DEGREE);
+    for (int k = 0; k <= POLYFIT_MAX_DEGREE; k++) {
+        p->coefficients[k] = ((k & 1) ? -1.0f : 1.0f) / (float)(k + 1);
+    }
+    Polynomial *d1 = polyfit_derivative(p, nullptr);
+    Polynomial *d2 = polyfit_derivative(d1, nullptr);
+
+    std::vector<float> xs, v(21), f(21), s(21);
+    for (int i = 0; i <= 20; i++) {
+        xs.push_back(-1.0f + 0.1f * i);
+    }
+    ASSERT_EQ(polyfit_evaluate_derivatives_batch(p, xs.data(), v.data(),
+                                                 f.data(), s.data(), 21),
+              POLYFIT_SUCCESS);
+    for (int i = 0; i <= 20; i++) {
+        float ev, ef, es;
+        polyfit_evaluate(p, xs[i], &ev);
+        polyfit_evaluate(d1, xs[i], &ef);
+        polyfit_evaluate(d2, xs[i], &es);
+        EXPECT_NEAR(v[i], ev, 1e-5f);
+        EXPECT_NEAR(f[i], ef, 1e-4f);
+        EXPECT_NEAR(s[i], es, 1e-3f);
+    }
+
+    // Degree POLYFIT_MAX_DEGREE has no antiderivative Polynomial, but it can
+    // still be integrated
+    polyfit_error_t error;
+    EXPECT_EQ(polyfit_antiderivative(p, &error), nullptr);
+    EXPECT_EQ(error, POLYFIT_ERROR_INVALID_DEGREE);
+    float forward, backward;
+    ASSERT_EQ(polyfit_integrate(p, -1.0f, 1.0f, &forward), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_integrate(p, 1.0f, -1.0f, &backward), POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(forward, -backward);
+    double expected = 0.0;  // odd powers cancel over [-1, 1]
+    for (int k = 0; k <= POLYFIT_MAX_DEGREE; k += 2) {
+        expected += 2.0 * p->coefficients[k] / (k + 1);
+    }
+    EXPECT_NEAR(forward, expected, 1e-6);
+
+    polyfit_free(d2);
+    polyfit_free(d1);
+    polyfit_free(p);
+}
+
+TEST(PolyfitCalculus, InvalidArguments) {
+    polyfit_error_t error;
+    float value, first, second;
+    EXPECT_EQ(polyfit_derivative(nullptr, &error), nullptr);
+    EXPECT_EQ(error, POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_antiderivative(nullptr, &error), nullptr);
+    EXPECT_EQ(error, POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_evaluate_derivatives(nullptr, 0.0f, &value, &first,
+                                           &second),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_integrate(nullptr, 0.0f, 1.0f, &value),
+              POLYFIT_ERROR_NULL_POINTER);
+
+    Polynomial *p = polyfit_init(2);
+    EXPECT_EQ(polyfit_evaluate_derivatives(p, 0.0f, &value, nullptr, &second),
+              POLYFIT_ERROR_NULL_POINTER);
+    EXPECT_EQ(polyfit_integrate(p, 0.0f, INFINITY, &value),
+              POLYFIT_ERROR_INVALID_INPUT);
+    p->is_valid = false;
+    EXPECT_EQ(polyfit_derivative(p, &error), nullptr);
+    EXPECT_EQ(error, POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_free(p);
+}
+
+/*============================================================================*/
+/* INSTRUMENTATION                                                            */
+/*============================================================================*/
+
+static bool stats_enabled() {
+    polyfit_stats_t stats;
+    return polyfit_stats_get(&stats) == POLYFIT_SUCCESS && stats.enabled;
+}
+
+TEST(PolyfitStats, SnapshotCountsFit) {
+    EXPECT_EQ(polyfit_stats_get(nullptr), POLYFIT_ERROR_NULL_POINTER);
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_NE(p, nullptr);
+    polyfit_stats_reset();
+    ASSERT_EQ(polyfit_least_squares(kQuadX, kQuadY, kQuadN, 2, p),
+              POLYFIT_SUCCESS);
+    polyfit_free(p);
+
+    polyfit_stats_t stats;
+    ASSERT_EQ(polyfit_stats_get(&stats), POLYFIT_SUCCESS);
+    if (!stats.enabled) {
+        // Compiled out: the snapshot is all zero
+        EXPECT_EQ(stats.fit_calls, 0u);
+        EXPECT_EQ(stats.points_processed, 0u);
+        return;
+    }
+
+    EXPECT_EQ(stats.fit_calls, 1u);
+    EXPECT_EQ(stats.points_processed, (uint64_t)kQuadN);
+    EXPECT_EQ(stats.allocations, 0u);
+    EXPECT_EQ(stats.singular_failures, 0u);
+    EXPECT_GT(stats.last_pivot_ratio, 0.0f);
+    EXPECT_LE(stats.last_pivot_ratio, 1.0f);
+}
+
+TEST(PolyfitStats, CountsSingularFailures) {
+    if (!stats_enabled()) {
+        GTEST_SKIP() << "built without POLYFIT_ENABLE_STATS";
+    }
+
+    const float x[] = {1.0f, 1.0f, 1.0f, 1.0f};
+    const float y[] = {1.0f, 2.0f, 3.0f, 4.0f};
+    Polynomial *p = polyfit_init(2);
+    polyfit_stats_reset();
+    EXPECT_EQ(polyfit_least_squares(x, y, 4, 2, p),
+              POLYFIT_ERROR_SINGULAR_MATRIX);
+    polyfit_free(p);
+
+    polyfit_stats_t stats;
+    ASSERT_EQ(polyfit_stats_get(&stats), POLYFIT_SUCCESS);
+    EXPECT_EQ(stats.fit_calls, 1u);
+    EXPECT_EQ(stats.singular_failures, 1u);
+    EXPECT_LT(stats.last_pivot_ratio, 1e-6f);
+}
+
+struct FitEventLog {
+    int calls = 0;
+    polyfit_fit_event_t last = {};
+};
+
+static void record_fit_event(const polyfit_fit_event_t *event,
+                             void *user_data) {
+    FitEventLog *log = static_cast<FitEventLog *>(user_data);
+    log->calls++;
+    log->last = *event;
+}
+
+TEST(PolyfitStats, CallbackReceivesEachSolve) {
+    if (!stats_enabled()) {
+        GTEST_SKIP() << "built without POLYFIT_ENABLE_STATS";
+    }
+
+    FitEventLog log;
+    ASSERT_EQ(polyfit_set_stats_callback(record_fit_event, &log),
+              POLYFIT_SUCCESS);
+    Polynomial *p = polyfit_init(3);
+    ASSERT_EQ(polyfit_least_squares(kQuadX, kQuadY, kQuadN, 3, p),
+              POLYFIT_SUCCESS);
+    EXPECT_EQ(polyfit_set_stats_callback(nullptr, nullptr), POLYFIT_SUCCESS);
+    ASSERT_EQ(polyfit_least_squares(kQuadX, kQuadY, kQuadN, 3, p),
+              POLYFIT_SUCCESS);
+    polyfit_free(p);
+
+    EXPECT_EQ(log.calls, 1);
+    EXPECT_EQ(log.last.degree, 3);
+    EXPECT_EQ(log.last.num_points, (int64_t)kQuadN);
+    EXPECT_EQ(log.last.error, POLYFIT_SUCCESS);
+    EXPECT_GT(log.last.pivot_ratio, 0.0f);
+}
+
 /*============================================================================*/
 /* UTILITY FUNCTIONS                                                          */
 /*============================================================================*/
@@ -0,0 +1,100 @@
+/**
+ * @file test_polyfit_hpp.cpp
+ * @brief Tests for the compile-time degree C++ header
+ */
+#include "polyfit.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+static const float kQuadX[] = {-3.0f, -2.0f, -1.0f, 0.0f, 1.0f,
+                                2.0f,  3.0f,  4.0f,  5.0f};
+static const float kQuadY[] = { 9.0f,  4.0f,  1.0f, 0.0f, 1.0f,
+                                4.0f,  9.0f, 16.0f, 25.0f};
+static const int   kQuadN   = 9;
+
+TEST(PolyfitTemplate, QuadraticMatchesRuntimeFit) {
+    polyfit_cxx::Fit<2> fit;
+    EXPECT_FALSE(fit.is_valid());
+    ASSERT_EQ(fit.fit(kQuadX, kQuadY, kQuadN), POLYFIT_SUCCESS);
+    EXPECT_TRUE(fit.is_valid());
+
+    Polynomial *p = polyfit(kQuadX, kQuadY, kQuadN, 2, nullptr);
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i <= 2; i++) {
+        EXPECT_NEAR(fit.coefficients()[i], p->coefficients[i], 1e-4f);
+    }
+    for (float x : {-2.5f, 0.0f, 1.25f, 4.0f}) {
+        float expected;
+        ASSERT_EQ(polyfit_evaluate(p, x, &expected), POLYFIT_SUCCESS);
+        EXPECT_NEAR(fit(x), expected, 1e-3f);
+    }
+    polyfit_free(p);
+}
+
+TEST(PolyfitTemplate, DoubleQuinticRecoversCoefficients) {
+    const double truth[] = {1.0, -0.5, 0.25, 2.0, -1.0, 0.125};
+    std::vector<double> x(50), y(50);
+    for (int i = 0; i < 50; i++) {
+        x[i] = -1.0 + 2.0 * i / 49.0;
+        double v = 0.0;
+        for (int k = 5; k >= 0; k--) v = v * x[i] + truth[k];
+        y[i] = v;
+    }
+
+    polyfit_cxx::Fit<5, double> fit;
+    ASSERT_EQ(fit.fit(x.data(), y.data(), 50), POLYFIT_SUCCESS);
+    for (int k = 0; k <= 5; k++) {
+        EXPECT_NEAR(fit.coefficients()[k], truth[k], 1e-8);
+    }
+
+    std::vector<double> out(50);
+    fit.evaluate(x.data(), out.data(), 50);
+    for (int i = 0; i < 50; i++) {
+        EXPECT_NEAR(out[i], y[i], 1e-9);
+    }
+}
+
+TEST(PolyfitTemplate, ErrorsMatchCLibrary) {
+    polyfit_cxx::Fit<3> fit;
+    EXPECT_EQ(fit.fit(kQuadX, kQuadY, 3), POLYFIT_ERROR_INSUFFICIENT_POINTS);
+    EXPECT_EQ(fit.fit(nullptr, kQuadY, kQuadN),
+              POLYFIT_ERROR_NULL_POINTER);
+
+    const float same_x[] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+    EXPECT_EQ(fit.fit(same_x, kQuadY, 5), POLYFIT_ERROR_SINGULAR_MATRIX);
+
+    float bad_x[] = {0.0f, 1.0f, NAN, 3.0f, 4.0f};
+    polyfit_cxx::Fit<0> constant;
+    EXPECT_EQ(constant.fit(bad_x, kQuadY, 5), POLYFIT_ERROR_INVALID_INPUT);
+    EXPECT_FALSE(constant.is_valid());
+}
+
+TEST(PolyfitTemplate, InteroperatesWithPolynomialAndMoments) {
+    polyfit_moments_t m;
+    ASSERT_EQ(polyfit_compute_moments(kQuadX, kQuadY, kQuadN, 3, &m),
+              POLYFIT_SUCCESS);
+    polyfit_cxx::Fit<2> fit;
+    ASSERT_EQ(fit.fit_moments(m), POLYFIT_SUCCESS);
+    EXPECT_NEAR(fit.coefficients()[2], 1.0f, 1e-4f);
+
+    Polynomial *p = polyfit_init(2);
+    ASSERT_EQ(fit.to_polynomial(p), POLYFIT_SUCCESS);
+    EXPECT_FLOAT_EQ(p->coefficients[2], fit.coefficients()[2]);
+
+    // A normalized C fit keeps its domain when loaded into a wider Fit
+    polyfit_config_t config = polyfit_default_config();
+    config.normalize_domain = true;
+    ASSERT_EQ(polyfit_least_squares_ex(kQuadX, kQuadY, kQuadN, 2, &config, p),
+              POLYFIT_SUCCESS);
+    polyfit_cxx::Fit<3> wide;
+    ASSERT_EQ(wide.from_polynomial(*p), POLYFIT_SUCCESS);
+    float expected;
+    ASSERT_EQ(polyfit_evaluate(p, 3.5f, &expected), POLYFIT_SUCCESS);
+    EXPECT_NEAR(wide(3.5f), expected, 1e-4f);
+
+    polyfit_cxx::Fit<1> narrow;
+    EXPECT_EQ(narrow.from_polynomial(*p), POLYFIT_ERROR_INVALID_DEGREE);
+    EXPECT_EQ(narrow.to_polynomial(p), POLYFIT_ERROR_INVALID_INPUT);
+    polyfit_free(p);
+}
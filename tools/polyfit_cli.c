@@ -0,0 +1,191 @@
+/**
+ ******************************************************************************
+ * @file    polyfit_cli.c
+ * @brief   Fit a polynomial to a binary capture of float32 x/y pairs
+ ******************************************************************************
+ * Usage: polyfit-cli [-d max_degree] [-c chunk_mib] file
+ *
+ * The file is a packed sequence of native-endian float32 (x, y) pairs. It is
+ * memory mapped and read sequentially in chunks: each chunk's moments are
+ * computed straight from the mapping with strided inputs and merged into a
+ * running total, and the pages of finished chunks are released, so files
+ * larger than RAM work. The degree is chosen by BIC from the merged moments
+ * and R-squared is derived from them too, so the data is read exactly once.
+ */
+
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "polyfit.h"
+
+/** @brief Bytes per (x, y) record */
+#define CLI_RECORD_SIZE (2 * sizeof(float))
+
+static double cli_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void cli_usage(const char* prog) {
+  fprintf(stderr,
+          "Usage: %s [-d max_degree] [-c chunk_mib] file\n"
+          "  file        packed native-endian float32 (x, y) pairs\n"
+          "  -d degree   highest degree to consider (1-%d, default 5)\n"
+          "  -c mib      chunk size in MiB (default 64)\n",
+          prog, POLYFIT_MAX_DEGREE);
+}
+
+int main(int argc, char** argv) {
+  int32_t max_degree = 5;
+  long chunk_mib = 64;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "d:c:h")) != -1) {
+    switch (opt) {
+      case 'd':
+        max_degree = (int32_t)atoi(optarg);
+        break;
+      case 'c':
+        chunk_mib = atol(optarg);
+        break;
+      default:
+        cli_usage(argv[0]);
+        return (opt == 'h') ? 0 : 2;
+    }
+  }
+
+  if (optind != argc - 1 || max_degree < 1 ||
+      max_degree > POLYFIT_MAX_DEGREE || chunk_mib <= 0) {
+    cli_usage(argv[0]);
+    return 2;
+  }
+
+  const char* path = argv[optind];
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return 1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    close(fd);
+    return 1;
+  }
+
+  const size_t file_size = (size_t)st.st_size;
+  const size_t num_records = file_size / CLI_RECORD_SIZE;
+  if (num_records <= (size_t)max_degree) {
+    fprintf(stderr, "%s: need more than %d (x, y) pairs\n", path,
+            (int)max_degree);
+    close(fd);
+    return 1;
+  }
+  if (file_size % CLI_RECORD_SIZE != 0) {
+    fprintf(stderr, "%s: ignoring %zu trailing bytes\n", path,
+            file_size % CLI_RECORD_SIZE);
+  }
+
+  const size_t map_size = num_records * CLI_RECORD_SIZE;
+  const unsigned char* map =
+      (const unsigned char*)mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "%s: mmap: %s\n", path, strerror(errno));
+    return 1;
+  }
+  madvise((void*)map, map_size, MADV_SEQUENTIAL);
+
+  // Chunks are a whole number of pages, so finished chunks can be released
+  // exactly, and hold at most INT32_MAX records
+  const size_t granule = (size_t)sysconf(_SC_PAGESIZE) * CLI_RECORD_SIZE;
+  size_t chunk_bytes = (size_t)chunk_mib << 20;
+  const size_t max_chunk = (size_t)INT32_MAX * CLI_RECORD_SIZE;
+  if (chunk_bytes > max_chunk) {
+    chunk_bytes = max_chunk;
+  }
+  chunk_bytes -= chunk_bytes % granule;
+  if (chunk_bytes == 0) {
+    chunk_bytes = granule;
+  }
+
+  polyfit_moments_t total;
+  polyfit_moments_t chunk;
+  polyfit_error_t error = POLYFIT_SUCCESS;
+  bool first = true;
+
+  double t0 = cli_now();
+  for (size_t offset = 0; offset < map_size && error == POLYFIT_SUCCESS;
+       offset += chunk_bytes) {
+    size_t bytes = map_size - offset;
+    if (bytes > chunk_bytes) {
+      bytes = chunk_bytes;
+    }
+
+    // x and y are read in place from the interleaved records
+    polyfit_input_t x = polyfit_input(map + offset, POLYFIT_TYPE_FLOAT);
+    polyfit_input_t y =
+        polyfit_input(map + offset + sizeof(float), POLYFIT_TYPE_FLOAT);
+    x.stride = (int32_t)CLI_RECORD_SIZE;
+    y.stride = (int32_t)CLI_RECORD_SIZE;
+
+    error = polyfit_compute_moments_typed(
+        &x, &y, (int32_t)(bytes / CLI_RECORD_SIZE), max_degree,
+        first ? &total : &chunk);
+    if (error == POLYFIT_SUCCESS && !first) {
+      error = polyfit_moments_merge(&total, &chunk);
+    }
+    first = false;
+
+    madvise((void*)(map + offset), bytes, MADV_DONTNEED);
+  }
+  double elapsed = cli_now() - t0;
+  munmap((void*)map, map_size);
+
+  if (error != POLYFIT_SUCCESS) {
+    fprintf(stderr, "%s: %s\n", path, polyfit_error_string(error));
+    return 1;
+  }
+
+  int32_t degree = 0;
+  Polynomial* poly =
+      polyfit_best_degree_moments(&total, max_degree, 0, &degree, &error);
+  if (poly == NULL) {
+    fprintf(stderr, "%s: %s\n", path, polyfit_error_string(error));
+    return 1;
+  }
+
+  // R^2 = 1 - RSS / SS_tot, both from the moments
+  double rss = 0.0;
+  polyfit_moments_rss(&total, poly, &rss);
+  const double n = (double)total.num_points;
+  const double ss_tot =
+      total.sum_y2 - total.cross_sums[0] * total.cross_sums[0] / n;
+  const double r_squared = (ss_tot > 0.0) ? 1.0 - rss / ss_tot : 1.0;
+
+  printf("points:       %lld\n", (long long)total.num_points);
+  printf("degree:       %d\n", (int)degree);
+  printf("coefficients:");
+  for (int32_t i = 0; i <= degree; i++) {
+    printf(" %.9g", (double)poly->coefficients[i]);
+  }
+  printf("\n");
+  printf("r_squared:    %.9f\n", r_squared);
+  printf("seconds:      %.3f\n", elapsed);
+  printf("throughput:   %.3f GB/s\n",
+         (elapsed > 0.0) ? (double)map_size / elapsed * 1e-9 : 0.0);
+
+  polyfit_free(poly);
+  return 0;
+}